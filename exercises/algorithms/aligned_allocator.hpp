@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef> //std::size_t
+#include <new>     //std::align_val_t, std::bad_alloc
+
+// Minimal allocator that hands out memory aligned to `Alignment` bytes
+// Notes:
+// - Our search layouts assume that index 0 of a block starts on a cache line boundary.
+//   std::vector only promises alignof(T), so we ask for more with C++17 aligned new.
+// - Use it like `std::vector<int, Aligned_Allocator<int>> v;`
+template<class T, std::size_t Alignment = 64>
+struct Aligned_Allocator {
+    using value_type = T;
+
+    template<class U>
+    struct rebind { using other = Aligned_Allocator<U, Alignment>; };
+
+    Aligned_Allocator() = default;
+
+    template<class U>
+    Aligned_Allocator( const Aligned_Allocator<U, Alignment>& ){ }
+
+    T* allocate( std::size_t n ){
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate( T* p, std::size_t ){
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<class U>
+    bool operator==( const Aligned_Allocator<U, Alignment>& ) const { return true; }
+};
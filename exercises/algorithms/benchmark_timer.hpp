@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>     //std::chrono::steady_clock
+#include <ranges>     //std::ranges::size
+
+// Shared timing code for the exercise drivers
+// Notes:
+// - Timed loops store their checksum in sink so the optimizer can't throw the work away. It is an
+//   inline variable, so every driver that includes this header shares the one definition.
+// - time_per_query leaves the sum of the answers in sink, drivers that print a checksum read it back.
+inline volatile long long sink;
+
+// Wall clock nanoseconds for one call of fn()
+template<class Fn>
+double time_ns( Fn&& fn ){
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = stop - start;
+    return elapsed.count();
+}
+
+// Average nanoseconds per query of lookup(q) over every q in queries, the results are summed into sink
+// Notes:
+// - Pass std::views::iota(0, n) to time n calls by index.
+template<class Queries, class Lookup>
+double time_per_query( const Queries& queries, Lookup&& lookup ){
+    long long sum = 0;
+    double elapsed = time_ns([&]{
+        for( const auto& q : queries ){ sum += static_cast<long long>(lookup(q)); }
+    });
+    sink = sum;
+    return elapsed / static_cast<double>(std::ranges::size(queries));
+}
+
+// Smallest result of runs calls of measure(), for DRAM bound loops where a shared box adds a lot of noise
+template<class Measure>
+double best_of( int runs, Measure&& measure ){
+    double best = measure();
+    for( int run = 1; run < runs; ++run ){
+        double elapsed = measure();
+        if( elapsed < best ){ best = elapsed; }
+    }
+    return best;
+}
@@ -1,54 +1,207 @@
-#include <iostream>
-#include <numeric>
-#include <array>
-#include <algorithm>
-
-
-// Note that Binary Search requires and ordered array!
-int binary_search( int search_array[], int val, int begin, int end ){
-    while(end >= 1) {
-        // Compute half the range
-        // Notes:
-        // - notice how we ensure that the halfway index is still an int. no doubles here!
-        // - integer truncation could occur here
-        int halfway = (begin + end)/2;
-
-        // Early return if our value happens to be exactly in the middle of the range
-        if( val == search_array[halfway] ) { return halfway; }
-
-        if( val < search_array[halfway] ){
-            end = halfway-1;
-        } else {
-            begin = halfway+1;
-        }
-
-        std::cout << "halfway: " << halfway << std::endl;
-    }
-
-
-    return -1;
-}
-
-int main(){
-
-    const auto SIZE = 10;
-    int a[SIZE];
-
-    // Initalized ordered array with linear increasing values
-    for( auto i = 0; i <= SIZE; ++i) {
-        a[i] = i;
-    }
-
-    for( auto e: a) {
-        std::cout << e << ", ";
-    }
-    std::cout << std::endl;
-
-    auto found = binary_search(a, a[SIZE/4], 0, SIZE);
-
-    std::cout << std::endl;
-    std::cout << "Searching for: " << a[SIZE/2] << std::endl;
-    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
-
-    return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <numeric>
+#include <array>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <string>
+#include <vector>
+#include "binary_search.hpp"
+#include "benchmark_timer.hpp"
+
+
+// The classic textbook loop. Left here so we can compare against the branchless engine.
+// Notes:
+// - Every probe takes a branch that depends on the data. With random queries the predictor is
+//   wrong about half the time and each miss flushes the pipeline.
+int branchy_binary_search( const int search_array[], int val, int begin, int end ){
+    while( begin <= end ) {
+        // notice how we avoid (begin + end)/2 so the sum can't overflow
+        int halfway = begin + (end - begin)/2;
+
+        if( val == search_array[halfway] ) { return halfway; }
+
+        if( val < search_array[halfway] ){
+            end = halfway-1;
+        } else {
+            begin = halfway+1;
+        }
+    }
+
+    return -1;
+}
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with linear increasing values
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = i;
+    }
+
+    for( auto e: a) {
+        std::cout << e << ", ";
+    }
+    std::cout << std::endl;
+
+    auto found = binary_search(a, a[SIZE/4], 0, SIZE-1);
+
+    std::cout << std::endl;
+    std::cout << "Searching for: " << a[SIZE/4] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
+
+    // The templated family works on any ordered key type
+    std::array<std::string, 6> words = { "apple", "banana", "banana", "banana", "cherry", "grape" };
+    std::string key = "banana";
+    auto lo = search::lower_bound(words.data(), words.size(), key);
+    auto hi = search::upper_bound(words.data(), words.size(), key);
+
+    std::cout << std::endl;
+    std::cout << "lower_bound(" << key << "): " << lo << std::endl;
+    std::cout << "upper_bound(" << key << "): " << hi << std::endl;
+    std::cout << "contains(" << key << "): " << std::boolalpha << search::contains(words.data(), words.size(), key) << std::endl;
+    std::cout << "contains(kiwi): " << search::contains(words.data(), words.size(), std::string("kiwi")) << std::endl;
+    auto run = search::equal_range(words.data(), words.size(), key);
+    std::cout << "equal_range(" << key << "): [" << run.lower << ", " << run.upper << ")" << std::endl;
+
+    // bounds, equal_range and both count_in_range against std::lower_bound/upper_bound
+    // Notes:
+    // - Values come from a range much smaller than the array, so runs of duplicates are long.
+    // - Key pairs cover lo == hi, hi < lo and keys off both ends. Sub ranges include empty ones.
+    std::mt19937 check_rng;
+    check_rng.seed(987654321);
+    for( int n = 0; n <= 2000; n += (n < 40 ? 1 : 37) ){
+        std::uniform_int_distribution<int> few_values(0, n / 8 + 1);
+        std::vector<int> dup(n);
+        for( auto& e : dup ){ e = few_values(check_rng); }
+        std::sort(dup.begin(), dup.end());
+
+        for( int lo = -2; lo <= n / 8 + 3; ++lo ){
+            for( int hi = lo - 2; hi <= lo + 3; ++hi ){
+                std::size_t expected_lower = std::lower_bound(dup.begin(), dup.end(), lo) - dup.begin();
+                std::size_t expected_upper = std::upper_bound(dup.begin(), dup.end(), hi) - dup.begin();
+                std::size_t expected_count = hi < lo ? 0 : expected_upper - expected_lower;
+                std::size_t key_upper = std::upper_bound(dup.begin(), dup.end(), lo) - dup.begin();
+
+                search::Bound_Pair both = search::bounds(dup.data(), dup.size(), lo, hi);
+                search::Bound_Pair same = search::equal_range(dup.data(), dup.size(), lo);
+                if( both.lower != expected_lower || both.upper != expected_upper
+                    || same.lower != expected_lower || same.upper != key_upper
+                    || search::count_in_range(dup.data(), dup.size(), lo, hi) != expected_count ){
+                    std::cout << "Bounds mismatch for [" << lo << ", " << hi << "] with " << n << " elements" << std::endl;
+                    return 1;
+                }
+
+                // the global wrapper on the inclusive index range [begin, end], end < begin is empty
+                int begin = n / 3, end = n - 1 - n / 4;
+                auto first = dup.begin() + begin, last = dup.begin() + (end < begin ? begin : end + 1);
+                int expected_sub = hi < lo ? 0 : static_cast<int>(std::upper_bound(first, last, hi) - std::lower_bound(first, last, lo));
+                if( count_in_range(dup.data(), lo, hi, begin, end) != expected_sub ){
+                    std::cout << "count_in_range mismatch for [" << lo << ", " << hi << "] in a[" << begin << ".." << end << "]" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    std::cout << "bounds, equal_range and count_in_range agree with std::lower_bound/upper_bound" << std::endl;
+
+    // Time random lookups on a table much larger than L2
+    // Notes:
+    // - 4M ints is 16MB. Each lookup walks ~22 levels and most of them miss in cache.
+    // - We sum the results so the optimizer can't throw the searches away.
+    const int BIG_SIZE = 1 << 22;
+    const int QUERIES  = 1 << 20;
+    std::vector<int> big(BIG_SIZE);
+    std::iota(big.begin(), big.end(), 0);
+
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> dist(0, BIG_SIZE-1);
+    std::vector<int> queries(QUERIES);
+    std::generate(queries.begin(), queries.end(), [&]{ return dist(rng); });
+
+    std::cout << std::endl << "Branchy binary search:" << std::endl;
+    double branchy_ns = time_per_query(queries, [&](int q){ return branchy_binary_search(big.data(), q, 0, BIG_SIZE-1); });
+    std::cout << "  checksum " << sink << ", " << branchy_ns << " ns/lookup" << std::endl;
+    std::cout << "Branchless binary search:" << std::endl;
+    double branchless_ns = time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, BIG_SIZE-1); });
+    std::cout << "  checksum " << sink << ", " << branchless_ns << " ns/lookup" << std::endl;
+
+    // Same lookups submitted as one batch. Check the answers, then time it.
+    std::vector<int> batch_results(QUERIES);
+    binary_search_batch(big.data(), 0, BIG_SIZE-1, queries, batch_results);
+    for( auto q = 0; q < QUERIES; ++q ){
+        if( batch_results[q] != binary_search(big.data(), queries[q], 0, BIG_SIZE-1) ){
+            std::cout << "Batch mismatch for key " << queries[q] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Batched binary search:" << std::endl;
+    double batch_ns = time_ns([&]{ binary_search_batch(big.data(), 0, BIG_SIZE-1, queries, batch_results); });
+    long long sum = std::accumulate(batch_results.begin(), batch_results.end(), 0LL);
+    std::cout << "  checksum " << sum << ", " << batch_ns / QUERIES << " ns/lookup" << std::endl;
+
+    // Same lookups with probe counting switched on
+    // Notes:
+    // - The counters live in a thread_local block, see probe_policy.hpp. The default policy compiles away.
+    std::cout << "Branchless binary search, counting probes:" << std::endl;
+    search::probe_stats().reset();
+    double counting_ns = time_per_query(queries, [&](int q){ return binary_search<search::Counting_Probes>(big.data(), q, 0, BIG_SIZE-1); });
+    std::cout << "  checksum " << sink << ", " << counting_ns << " ns/lookup" << std::endl;
+
+    // Skewed queries: only the bottom 1/16 of the table. Watch the top levels always go left.
+    auto report = [](const char* name){
+        const search::Probe_Stats& stats = search::probe_stats();
+        std::cout << std::endl << name << ": " << stats.lookups << " lookups, " << stats.probes_per_lookup() << " probes/lookup, "
+                  << stats.left << " left / " << stats.right << " right" << std::endl;
+        std::cout << "  lookups by depth:";
+        for( std::size_t d = 0; d < search::Probe_Stats::MAX_DEPTH; ++d ){
+            if( stats.depth_histogram[d] != 0 ){ std::cout << " " << d << ":" << stats.depth_histogram[d]; }
+        }
+        std::cout << std::endl << "  went right at level 0..5:";
+        for( std::size_t d = 0; d < 6; ++d ){
+            std::cout << " " << static_cast<double>(stats.right_at_depth[d]) / static_cast<double>(stats.probes_at_depth[d]);
+        }
+        std::cout << std::endl;
+    };
+    report("Uniform queries");
+
+    search::probe_stats().reset();
+    for( auto q : queries ){ search::contains<search::Counting_Probes>(big.data(), big.size(), q % (BIG_SIZE / 16)); }
+    report("Bottom 1/16 queries");
+
+    // Range counts over a table full of duplicates
+    // Notes:
+    // - Every value shows up 4096 times. Walking outward from a binary_search hit touches every copy,
+    //   count_in_range does two bound searches and shares the top of the tree between them.
+    const int RUN = 4096;
+    std::vector<int> runs(BIG_SIZE);
+    for( int i = 0; i < BIG_SIZE; ++i ){ runs[i] = i / RUN; }
+    const int RANGE_QUERIES = 1 << 14;
+    std::uniform_int_distribution<int> any_run(0, BIG_SIZE / RUN - 1);
+    std::vector<int> run_keys(RANGE_QUERIES);
+    std::generate(run_keys.begin(), run_keys.end(), [&]{ return any_run(rng); });
+
+    auto walk_outward = [&](int lo, int hi){
+        long long count = 0;
+        for( int v = lo; v <= hi; ++v ){
+            int hit = binary_search(runs.data(), v, 0, BIG_SIZE-1);
+            for( int i = hit; i != -1 && i < BIG_SIZE && runs[i] == v; ++i ){ ++count; }
+        }
+        return count;
+    };
+
+    std::cout << std::endl << "Counting keys in [k, k+2] with " << RUN << " copies of each key:" << std::endl;
+    double walk_ns = time_per_query(run_keys, [&](int k){ return walk_outward(k, k + 2); });
+    std::cout << "  walk outward from binary_search: " << sink << " keys, " << walk_ns << " ns/query" << std::endl;
+    double pair_ns = time_per_query(run_keys, [&](int k){
+        return search::upper_bound(runs.data(), runs.size(), k + 2) - search::lower_bound(runs.data(), runs.size(), k);
+    });
+    std::cout << "  lower_bound + upper_bound:       " << sink << " keys, " << pair_ns << " ns/query" << std::endl;
+    double count_ns = time_per_query(run_keys, [&](int k){ return count_in_range(runs.data(), k, k + 2, 0, BIG_SIZE-1); });
+    std::cout << "  count_in_range:                  " << sink << " keys, " << count_ns << " ns/query" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstddef>    //std::size_t
+#include <functional> //std::less
+#include <span>       //std::span
+#include <type_traits> //std::is_constant_evaluated, std::is_integral_v
+#include "probe_policy.hpp"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <xmmintrin.h> //_mm_prefetch
+#endif
+
+namespace search {
+
+// Hint to the cpu that we will read the cache line holding `address` soon
+// Notes:
+// - Prefetches never fault, so it is fine to hint at an address we might not end up reading.
+// - constexpr so the searches below can run at compile time. There it simply does nothing.
+constexpr void prefetch( const void* address ){
+    if( std::is_constant_evaluated() ){ return; }
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#elif defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+// Pick if_true or if_false without a branch
+// Notes:
+// - The hot loops of the searches in this folder feed data dependent compares into selects, not
+//   branches. Hit or miss, left or right is a coin flip for the predictor, and every wrong guess
+//   throws away the loads of the next step (or the next lookup) that already started.
+// - In a loop as small as lower_bound's, `cond ? a : b` becomes a cmov and we keep the ternary. gcc
+//   doesn't promise that though: in bigger loop bodies, and after inlining, it can turn the ternary
+//   back into a branch (the van Emde Boas descent is one such loop). Building the answer from an all
+//   ones or all zeros mask leaves it nothing to branch on.
+// - `base + step * cond` is the same idea for offsets. Code that needs either form points here
+//   instead of repeating this note.
+template<class T>
+    requires std::is_integral_v<T>
+constexpr T select( bool cond, T if_true, T if_false ){
+    T mask = static_cast<T>(T(0) - static_cast<T>(cond));
+    return static_cast<T>((if_true & mask) | (if_false & ~mask));
+}
+
+// Branchless lower bound over a sorted array
+// Notes:
+// - Returns the first index i in [0, n) such that !comp(data[i], key), or n if every element is smaller.
+// - Instead of tracking `begin`/`end` we keep a base pointer and a shrinking length. Every iteration
+//   halves the length no matter what the comparison says, so the trip count only depends on n.
+// - The comparison only selects the next base pointer. In a loop this small the ternary is lowered to
+//   a cmov (a mask from search::select would add a cycle per level), so there is no data dependent
+//   branch for the predictor to get wrong. Check the asm if you grow the loop body.
+// - Without branches the cpu can no longer speculate down one side of the tree and start that load
+//   early. We win that back by prefetching the midpoints of both possible next ranges.
+// - Works for any key type with a strict weak ordering. Pass a custom comparator for anything fancy.
+// - Probes is the instrumentation policy from probe_policy.hpp. The default No_Probes costs nothing.
+template<class Probes = No_Probes, class T, class Compare = std::less<>>
+constexpr std::size_t lower_bound( const T* data, std::size_t n, const T& key, Compare comp = Compare{} ){
+    if( n == 0 ){
+        Probes::lookup(0);
+        return 0;
+    }
+
+    const T* base = data;
+    std::size_t depth = 0;
+    while( n > 1 ){
+        std::size_t half = n / 2;
+        search::prefetch(base + half / 2);
+        search::prefetch(base + half + half / 2);
+        bool right = comp(base[half], key);
+        Probes::probe(depth++, right);
+        base = right ? base + half : base;
+        n -= half;
+    }
+
+    bool past = comp(*base, key);
+    Probes::probe(depth++, past);
+    Probes::lookup(depth);
+    return static_cast<std::size_t>(base - data) + past;
+}
+
+// Branchless upper bound over a sorted array
+// Notes:
+// - Returns the first index i in [0, n) such that comp(key, data[i]), or n if no element is greater.
+// - Same shape as lower_bound, we only flip the question we ask at each probe.
+template<class Probes = No_Probes, class T, class Compare = std::less<>>
+constexpr std::size_t upper_bound( const T* data, std::size_t n, const T& key, Compare comp = Compare{} ){
+    if( n == 0 ){
+        Probes::lookup(0);
+        return 0;
+    }
+
+    const T* base = data;
+    std::size_t depth = 0;
+    while( n > 1 ){
+        std::size_t half = n / 2;
+        search::prefetch(base + half / 2);
+        search::prefetch(base + half + half / 2);
+        bool right = !comp(key, base[half]);
+        Probes::probe(depth++, right);
+        base = right ? base + half : base;
+        n -= half;
+    }
+
+    bool past = !comp(key, *base);
+    Probes::probe(depth++, past);
+    Probes::lookup(depth);
+    return static_cast<std::size_t>(base - data) + past;
+}
+
+// Membership test built on lower_bound
+// Notes:
+// - lower_bound lands on the first element that is not less than key.
+//   The key is present iff that element is also not greater than key.
+template<class Probes = No_Probes, class T, class Compare = std::less<>>
+constexpr bool contains( const T* data, std::size_t n, const T& key, Compare comp = Compare{} ){
+    std::size_t i = search::lower_bound<Probes>(data, n, key, comp);
+    return i < n && !comp(key, data[i]);
+}
+
+// Result of a two sided search: data[lower, upper) is the matching run
+struct Bound_Pair {
+    std::size_t lower;
+    std::size_t upper;
+};
+
+// lower_bound(lo) and upper_bound(hi) in one descent
+// Notes:
+// - Both searches probe the same elements until the two keys fall on different sides of a probe.
+//   Up to there we only walk the tree once and answer two questions per probe.
+// - After they split each one finishes on its own. The branchless loop's whole state is a base
+//   pointer and a length, so we just hand those to lower_bound and upper_bound.
+// - The split is the only branch, and it is taken at most once per call.
+// - With lo == hi this is equal_range. For close keys most of the descent is shared.
+template<class T, class Compare = std::less<>>
+constexpr Bound_Pair bounds( const T* data, std::size_t n, const T& lo, const T& hi, Compare comp = Compare{} ){
+    if( n == 0 ){ return { 0, 0 }; }
+
+    const T* base = data;
+    while( n > 1 ){
+        std::size_t half = n / 2;
+        bool lo_right = comp(base[half], lo);
+        bool hi_right = !comp(hi, base[half]);
+        if( lo_right != hi_right ){
+            const T* lo_base = lo_right ? base + half : base;
+            const T* hi_base = hi_right ? base + half : base;
+            n -= half;
+            return { static_cast<std::size_t>(lo_base - data) + search::lower_bound(lo_base, n, lo, comp),
+                     static_cast<std::size_t>(hi_base - data) + search::upper_bound(hi_base, n, hi, comp) };
+        }
+        search::prefetch(base + half / 2);
+        search::prefetch(base + half + half / 2);
+        base = lo_right ? base + half : base;
+        n -= half;
+    }
+
+    std::size_t at = static_cast<std::size_t>(base - data);
+    return { at + comp(*base, lo), at + !comp(hi, *base) };
+}
+
+// The run of elements equivalent to key, same as std::equal_range but on the branchless loop
+template<class T, class Compare = std::less<>>
+constexpr Bound_Pair equal_range( const T* data, std::size_t n, const T& key, Compare comp = Compare{} ){
+    return search::bounds(data, n, key, key, comp);
+}
+
+// How many elements lie in the closed range [lo, hi]
+// Notes:
+// - Two bound searches, so O(log n) no matter how many duplicates there are. Walking outward from
+//   a single hit would cost O(k) for k matches.
+// - An empty range (hi < lo) counts 0.
+template<class T, class Compare = std::less<>>
+constexpr std::size_t count_in_range( const T* data, std::size_t n, const T& lo, const T& hi, Compare comp = Compare{} ){
+    if( comp(hi, lo) ){ return 0; }
+    Bound_Pair b = search::bounds(data, n, lo, hi, comp);
+    return b.upper - b.lower;
+}
+
+// Batched lower bound that runs a group of searches in lockstep
+// Notes:
+// - Every search over the same array shrinks its length the same way, so a whole group of queries
+//   can move down one level together. Only the base pointers differ.
+// - After stepping a query we prefetch the element it will probe next and move on to the rest of the
+//   group. By the time we come back around that load has had Group-1 other probes to hide behind,
+//   so the memory system works on many misses at once instead of one.
+// - results[i] receives lower_bound(data, queries[i]). results must be at least as long as queries.
+// - Group sizes between 8 and 32 keep the base pointers in registers/L1 and still cover DRAM latency.
+template<std::size_t Group = 16, class T, class Compare = std::less<>>
+void lower_bound_batch( std::span<const T> data, std::span<const T> queries, std::span<std::size_t> results, Compare comp = Compare{} ){
+    static_assert(Group >= 1, "Group must hold at least one query");
+
+    const std::size_t count = queries.size();
+    if( data.empty() ){
+        for( std::size_t q = 0; q < count; ++q ){ results[q] = 0; }
+        return;
+    }
+
+    const T* bases[Group];
+    for( std::size_t first = 0; first < count; first += Group ){
+        const std::size_t m = count - first < Group ? count - first : Group;
+        const T* keys = queries.data() + first;
+
+        for( std::size_t g = 0; g < m; ++g ){ bases[g] = data.data(); }
+
+        std::size_t n = data.size();
+        while( n > 1 ){
+            std::size_t half = n / 2;
+            std::size_t next_half = (n - half) / 2;
+            for( std::size_t g = 0; g < m; ++g ){
+                bases[g] = comp(bases[g][half], keys[g]) ? bases[g] + half : bases[g];
+                search::prefetch(bases[g] + next_half);
+            }
+            n -= half;
+        }
+
+        for( std::size_t g = 0; g < m; ++g ){
+            results[first + g] = static_cast<std::size_t>(bases[g] - data.data()) + comp(*bases[g], keys[g]);
+        }
+    }
+}
+
+} // namespace search
+
+// Note that Binary Search requires and ordered array!
+// Notes:
+// - Kept for existing callers: searches the inclusive range [begin, end] and returns the index of val or -1.
+// - When val appears more than once we return the first occurrence.
+// - This is a thin wrapper over search::lower_bound so it shares the branchless loop.
+// - binary_search<search::Counting_Probes>(...) records every probe, see probe_policy.hpp.
+template<class Probes = search::No_Probes>
+constexpr int binary_search( const int search_array[], int val, int begin, int end ){
+    if( end < begin ){ return -1; }
+
+    std::size_t n = static_cast<std::size_t>(end - begin) + 1;
+    std::size_t i = search::lower_bound<Probes>(search_array + begin, n, val);
+
+    if( i < n && search_array[begin + i] == val ){ return begin + static_cast<int>(i); }
+    return -1;
+}
+
+// How many values of the inclusive index range [begin, end] lie in [lo, hi]
+constexpr int count_in_range( const int search_array[], int lo, int hi, int begin, int end ){
+    if( end < begin ){ return 0; }
+    std::size_t n = static_cast<std::size_t>(end - begin) + 1;
+    return static_cast<int>(search::count_in_range(search_array + begin, n, lo, hi));
+}
+
+// Batched binary_search over the inclusive range [begin, end]
+// Notes:
+// - results[i] is exactly what binary_search(search_array, queries[i], begin, end) would return.
+// - The lower bounds are computed in place in a small stack buffer, one chunk at a time, so we don't
+//   allocate for large batches.
+inline void binary_search_batch( const int search_array[], int begin, int end, std::span<const int> queries, std::span<int> results ){
+    const std::size_t CHUNK = 256;
+    std::size_t bounds[CHUNK];
+
+    std::span<const int> data;
+    if( end >= begin ){ data = std::span<const int>(search_array + begin, static_cast<std::size_t>(end - begin) + 1); }
+
+    for( std::size_t first = 0; first < queries.size(); first += CHUNK ){
+        std::size_t m = queries.size() - first < CHUNK ? queries.size() - first : CHUNK;
+        search::lower_bound_batch(data, queries.subspan(first, m), std::span<std::size_t>(bounds, m));
+
+        for( std::size_t q = 0; q < m; ++q ){
+            std::size_t i = bounds[q];
+            bool hit = i < data.size() && data[i] == queries[first + q];
+            results[first + q] = hit ? begin + static_cast<int>(i) : -1;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <array>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "constexpr_search.hpp"
+#include "benchmark_timer.hpp"
+
+// Opcodes our toy decoder understands. Listed in any order, sorted by the compiler.
+constexpr Sorted_Table OPCODES(std::array<int, 12>{ 0x90, 0x01, 0xC3, 0x89, 0x8B, 0xE8, 0xE9, 0x31, 0x29, 0x83, 0x74, 0x75 });
+
+// Latency histogram bucket boundaries in microseconds
+constexpr Sorted_Table BUCKETS(std::array<int, 16>{ 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000, 50000, 100000 });
+
+// Everything below is checked by the compiler. If any of it were wrong the file wouldn't build.
+static_assert(OPCODES[0] == 0x01 && OPCODES[11] == 0xE9, "table is sorted at compile time");
+static_assert(OPCODES.contains(0xC3));
+static_assert(!OPCODES.contains(0xCC));
+static_assert(binary_search(OPCODES, 0x90) == 8);
+static_assert(binary_search(OPCODES, 0x00) == -1);
+static_assert(BUCKETS.upper_bound(0) == 0);
+static_assert(BUCKETS.upper_bound(7) == 3);
+static_assert(BUCKETS.upper_bound(1000000) == 16);
+
+// The runtime binary_search is constexpr too
+constexpr std::array<int, 5> SMALL = { 1, 3, 5, 7, 9 };
+static_assert(binary_search(SMALL.data(), 7, 0, 4) == 3);
+
+int main(){
+
+    // A constant key folds to a constant, there is no search left in the binary
+    constexpr int ret = binary_search(OPCODES, 0xC3);
+    std::cout << "ret (0xC3) is opcode #" << ret << std::endl;
+
+    // Runtime keys run the unrolled comparison tree
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> latency(0, 200000);
+    std::cout << "Bucket for a few random latencies:" << std::endl;
+    for( int i = 0; i < 5; ++i ){
+        int us = latency(rng);
+        std::cout << "  " << us << "us -> bucket " << BUCKETS.upper_bound(us) << std::endl;
+    }
+
+    // Check the unrolled search against the runtime one for every key in range
+    for( int key = -1; key <= 100001; ++key ){
+        if( binary_search(BUCKETS, key) != binary_search(BUCKETS.data(), key, 0, 15)
+            || BUCKETS.upper_bound(key) != search::upper_bound(BUCKETS.data(), 16, key) ){
+            std::cout << "Mismatch for key " << key << std::endl;
+            return 1;
+        }
+    }
+
+    // Time the two on the same runtime keys
+    const int QUERIES = 1 << 22;
+    std::vector<int> queries(QUERIES);
+    for( auto& q : queries ){ q = latency(rng); }
+
+    std::array<int, 16> runtime_buckets;
+    for( std::size_t i = 0; i < runtime_buckets.size(); ++i ){ runtime_buckets[i] = BUCKETS[i]; }
+    volatile std::size_t runtime_size = runtime_buckets.size();
+
+    std::cout << std::endl << "Bucketing " << QUERIES << " latencies:" << std::endl;
+    std::cout << "  runtime size:  " << time_per_query(queries, [&](int q){ return search::upper_bound(runtime_buckets.data(), runtime_size, q); }) << " ns" << std::endl;
+    std::cout << "  Sorted_Table:  " << time_per_query(queries, [&](int q){ return BUCKETS.upper_bound(q); }) << " ns" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>  //std::sort
+#include <array>
+#include <cstddef>    //std::size_t
+#include <functional> //std::less
+#include <utility>    //std::index_sequence
+#include "binary_search.hpp"
+
+namespace search {
+
+// Number of halving steps the branchless lower bound takes on n elements
+constexpr std::size_t halving_steps( std::size_t n ){
+    std::size_t steps = 0;
+    while( n > 1 ){
+        n -= n / 2;
+        ++steps;
+    }
+    return steps;
+}
+
+// The `half` used at every step of the branchless lower bound on N elements
+// Notes:
+// - The lower bound loop shrinks its length the same way for every key, so for a fixed table size
+//   the whole sequence of probe offsets is known at compile time.
+template<std::size_t N>
+constexpr std::array<std::size_t, halving_steps(N)> halving_offsets(){
+    std::array<std::size_t, halving_steps(N)> halves{};
+    std::size_t n = N;
+    for( std::size_t i = 0; i < halves.size(); ++i ){
+        halves[i] = n / 2;
+        n -= halves[i];
+    }
+    return halves;
+}
+
+} // namespace search
+
+// Sorted lookup table whose contents are known at compile time
+// Notes:
+// - Build it as a constexpr variable from an std::array in any order. The constructor sorts it while
+//   compiling (std::sort is constexpr in C++20), so there is no runtime initialization at all.
+// - lower_bound is the same branchless search as search::lower_bound, but the size is a template
+//   parameter, so we expand the loop with a fold expression: one compare per level, no loop counter.
+//   The step is added as half * (compare result) instead of a ?:, see search::select in
+//   binary_search.hpp. A 64 entry table is exactly 7 compares, always.
+// - Every lookup is constexpr. With a constant key the compiler folds the answer to a constant.
+template<class T, std::size_t N, class Compare = std::less<>>
+class Sorted_Table {
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static_assert(N > 0, "Sorted_Table needs at least one key");
+
+    private:
+        std::array<value_type, N> keys;
+
+        static constexpr auto HALVES = search::halving_offsets<N>();
+
+        template<std::size_t... I>
+        constexpr size_type unrolled_lower_bound( const value_type& key, std::index_sequence<I...> ) const {
+            Compare comp{};
+            size_type base = 0;
+            ((base += HALVES[I] * comp(keys[base + HALVES[I]], key)), ...);
+            return base + comp(keys[base], key);
+        }
+
+        template<std::size_t... I>
+        constexpr size_type unrolled_upper_bound( const value_type& key, std::index_sequence<I...> ) const {
+            Compare comp{};
+            size_type base = 0;
+            ((base += HALVES[I] * !comp(key, keys[base + HALVES[I]])), ...);
+            return base + !comp(key, keys[base]);
+        }
+
+    public:
+        constexpr explicit Sorted_Table( const std::array<value_type, N>& values ):
+            keys(values)
+        {
+            std::sort(keys.begin(), keys.end(), Compare{});
+        }
+
+        constexpr size_type getSize() const { return N; }
+        constexpr const value_type& operator[]( size_type i ) const { return keys[i]; }
+        constexpr const value_type* data() const { return keys.data(); }
+
+        // Index of the first key not less than key, or N
+        constexpr size_type lower_bound( const value_type& key ) const {
+            return unrolled_lower_bound(key, std::make_index_sequence<HALVES.size()>{});
+        }
+
+        // Index of the first key greater than key, or N
+        constexpr size_type upper_bound( const value_type& key ) const {
+            return unrolled_upper_bound(key, std::make_index_sequence<HALVES.size()>{});
+        }
+
+        constexpr bool contains( const value_type& key ) const {
+            size_type i = lower_bound(key);
+            return i < N && !Compare{}(key, keys[i]);
+        }
+};
+
+// constexpr binary_search over a Sorted_Table
+// Notes:
+// - Same contract as binary_search: index of the first occurrence of val, or -1.
+template<class T, std::size_t N, class Compare>
+constexpr int binary_search( const Sorted_Table<T, N, Compare>& table, const T& val ){
+    std::size_t i = table.lower_bound(val);
+    return (i < N && !Compare{}(val, table[i])) ? static_cast<int>(i) : -1;
+}
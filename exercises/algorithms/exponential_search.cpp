@@ -0,0 +1,93 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "exponential_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with linear increasing values
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = i;
+    }
+
+    auto found = exponential_search(a, a[SIZE/4], 0, SIZE-1);
+    std::cout << "Searching for: " << a[SIZE/4] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
+
+    // Gallop both ways from a cursor
+    Gallop_Cursor<int> cursor(a, SIZE, SIZE/2);
+    std::cout << "Cursor starts @ " << cursor.getPosition() << std::endl;
+    std::cout << "seek(8) -> " << cursor.seek(8) << std::endl;
+    std::cout << "seek(1) -> " << cursor.seek(1) << std::endl;
+    std::cout << "seek(99) -> " << cursor.seek(99) << " (end)" << std::endl;
+
+    // Check every hint against binary_search, with duplicates and misses
+    std::mt19937 rng;
+    rng.seed(123456789);
+    for( int n = 0; n < 100; ++n ){
+        std::vector<int> data(n);
+        for( auto i = 0; i < n; ++i ){ data[i] = 2*(i - i % 3); }
+        for( int val = -2; val <= 2*n + 2; ++val ){
+            int expected = binary_search(data.data(), val, 0, n-1);
+            std::size_t bound = search::lower_bound(data.data(), data.size(), val);
+            for( int hint = 0; hint <= n; ++hint ){
+                if( search::gallop_lower_bound(data.data(), data.size(), val, hint) != bound ){
+                    std::cout << "Mismatch for n = " << n << " key " << val << " hint " << hint << std::endl;
+                    return 1;
+                }
+            }
+            if( exponential_search(data.data(), val, 0, n-1) != expected ){
+                std::cout << "Mismatch for n = " << n << " key " << val << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Front biased queries on a big table
+    // Notes:
+    // - The hits are all in the first thousand slots of a 4M element array.
+    const int BIG_SIZE = 1 << 22;
+    const int QUERIES  = 1 << 20;
+    std::vector<int> big(BIG_SIZE);
+    for( auto i = 0; i < BIG_SIZE; ++i ){ big[i] = 2*i; }
+
+    std::uniform_int_distribution<int> near_front(0, 2000);
+    std::vector<int> queries(QUERIES);
+    std::generate(queries.begin(), queries.end(), [&]{ return near_front(rng); });
+
+    std::cout << std::endl << "Front biased lookups:" << std::endl;
+    std::cout << "  binary:      " << time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, BIG_SIZE-1); }) << " ns/lookup" << std::endl;
+    std::cout << "  exponential: " << time_per_query(queries, [&](int q){ return exponential_search(big.data(), q, 0, BIG_SIZE-1); }) << " ns/lookup" << std::endl;
+
+    // Merge style scan: intersect a short sorted list with the big table using one forward cursor
+    std::vector<int> probes(QUERIES);
+    std::uniform_int_distribution<int> anywhere(0, 2*BIG_SIZE-1);
+    std::generate(probes.begin(), probes.end(), [&]{ return anywhere(rng); });
+    std::sort(probes.begin(), probes.end());
+
+    long long common = 0;
+    double cursor_ns = time_ns([&]{
+        Gallop_Cursor<int> scan(big.data(), big.size());
+        for( auto p : probes ){
+            scan.seek_forward(p);
+            common += scan.matches(p);
+        }
+    });
+
+    long long common_binary = 0;
+    double binary_ns = time_ns([&]{
+        for( auto p : probes ){ common_binary += binary_search(big.data(), p, 0, BIG_SIZE-1) != -1; }
+    });
+
+    std::cout << std::endl << "Intersecting " << QUERIES << " sorted keys with the table:" << std::endl;
+    std::cout << "  binary per key: " << common_binary << " common, " << binary_ns / QUERIES << " ns/key" << std::endl;
+    std::cout << "  gallop cursor:  " << common << " common, " << cursor_ns / QUERIES << " ns/key" << std::endl;
+
+    return 0;
+}
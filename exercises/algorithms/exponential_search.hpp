@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>    //std::size_t
+#include <functional> //std::less
+#include "binary_search.hpp"
+
+namespace search {
+
+// Gallop forward from a position we know is before the answer
+// Notes:
+// - Requires comp(data[i], key) for every i < from, i.e. the lower bound is at or after `from`.
+// - Probe from+1, from+3, from+7, ... doubling the stride until we step past the key, then bisect the
+//   last bracket. If the answer is d elements away this costs about 2*log2(d) probes, no matter how
+//   big n is.
+template<class T, class Compare = std::less<>>
+std::size_t gallop_forward( const T* data, std::size_t n, const T& key, std::size_t from, Compare comp = Compare{} ){
+    if( from >= n ){ return n; }
+    if( !comp(data[from], key) ){ return from; }
+
+    // Invariant: data[lo] < key, so the answer is in (lo, n]
+    std::size_t lo = from;
+    std::size_t step = 1;
+    while( step < n - lo ){
+        std::size_t probe = lo + step;
+        if( !comp(data[probe], key) ){
+            return lo + 1 + search::lower_bound(data + lo + 1, probe - lo - 1, key, comp);
+        }
+        lo = probe;
+        step *= 2;
+    }
+
+    return lo + 1 + search::lower_bound(data + lo + 1, n - lo - 1, key, comp);
+}
+
+// Gallop backward from a position we know is at or after the answer
+// Notes:
+// - Requires !comp(data[i], key) for every i in [from, n), i.e. the lower bound is at or before `from`.
+// - Mirror image of gallop_forward.
+template<class T, class Compare = std::less<>>
+std::size_t gallop_backward( const T* data, std::size_t n, const T& key, std::size_t from, Compare comp = Compare{} ){
+    if( from > n ){ from = n; }
+    if( from == 0 || comp(data[from-1], key) ){ return from; }
+
+    // Invariant: data[hi] >= key, so the answer is in [0, hi]
+    std::size_t hi = from - 1;
+    std::size_t step = 1;
+    while( step <= hi ){
+        std::size_t probe = hi - step;
+        if( comp(data[probe], key) ){
+            return probe + 1 + search::lower_bound(data + probe + 1, hi - probe - 1, key, comp);
+        }
+        hi = probe;
+        step *= 2;
+    }
+
+    return search::lower_bound(data, hi, key, comp);
+}
+
+// Lower bound starting from a hint, galloping whichever way the key is
+// Notes:
+// - Good hints are the previous answer, or 0 when queries cluster at the front of the array.
+template<class T, class Compare = std::less<>>
+std::size_t gallop_lower_bound( const T* data, std::size_t n, const T& key, std::size_t hint, Compare comp = Compare{} ){
+    if( hint < n && comp(data[hint], key) ){
+        return search::gallop_forward(data, n, key, hint, comp);
+    }
+    return search::gallop_backward(data, n, key, hint, comp);
+}
+
+} // namespace search
+
+// Cursor into a sorted array that remembers where the last lookup landed
+// Notes:
+// - seek() gallops from the previous position, so walking a sorted array with increasing (or slowly
+//   changing) keys costs O(log d) per step, where d is how far the cursor moves.
+// - This is the building block for merge style scans: intersect two sorted lists by seeking a cursor
+//   on the longer list with each key of the shorter one.
+template<class T, class Compare = std::less<>>
+class Gallop_Cursor {
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    private:
+        const value_type* data;
+        size_type size;
+        size_type pos;
+        Compare comp;
+
+    public:
+        Gallop_Cursor( const value_type* data, size_type size, size_type start = 0, Compare comp = Compare{} ):
+            data(data),
+            size(size),
+            pos(start < size ? start : size),
+            comp(comp)
+        { }
+
+        size_type getPosition() const { return pos; }
+        size_type getSize() const { return size; }
+        bool atEnd() const { return pos == size; }
+
+        // Move to the first element >= key, galloping forward or backward from the current position
+        size_type seek( const value_type& key ){
+            pos = search::gallop_lower_bound(data, size, key, pos, comp);
+            return pos;
+        }
+
+        // Only ever move forward. Cheaper when the caller knows keys are increasing.
+        size_type seek_forward( const value_type& key ){
+            pos = search::gallop_forward(data, size, key, pos, comp);
+            return pos;
+        }
+
+        // True if the element under the cursor equals key
+        bool matches( const value_type& key ) const {
+            return pos < size && !comp(key, data[pos]) && !comp(data[pos], key);
+        }
+};
+
+// Exponential search over the inclusive range [begin, end], galloping from the front
+// Notes:
+// - Same contract as binary_search: index of the first occurrence of val, or -1.
+// - Costs O(log i) where i is the position of val, so it wins when hits are near the front.
+inline int exponential_search( const int search_array[], int val, int begin, int end ){
+    if( end < begin ){ return -1; }
+
+    std::size_t n = static_cast<std::size_t>(end - begin) + 1;
+    std::size_t i = search::gallop_forward(search_array + begin, n, val, 0);
+
+    if( i < n && search_array[begin + i] == val ){ return begin + static_cast<int>(i); }
+    return -1;
+}
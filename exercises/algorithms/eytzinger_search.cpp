@@ -0,0 +1,59 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "eytzinger_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with even values so odd keys are misses
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = 2*i;
+    }
+
+    Eytzinger_Index index(a, 0, SIZE-1);
+
+    std::cout << "Searching keys 0 through " << 2*SIZE << std::endl;
+    for( auto val = 0; val <= 2*SIZE; ++val ){
+        std::cout << val << " -> eytzinger: " << index.search(val)
+                  << " binary: " << binary_search(a, val, 0, SIZE-1) << std::endl;
+    }
+
+    // Compare both layouts with random lookups on tables from L2 sized up to well past LLC
+    // Notes:
+    // - Half the queries are misses so we also exercise the "not found" path.
+    // - Every rank is checked against binary_search before we trust the timings.
+    const int QUERIES = 1 << 20;
+    std::mt19937 rng;
+    rng.seed(123456789);
+
+    std::cout << std::endl << "     elements  binary ns  eytzinger ns" << std::endl;
+    for( int big_size = 1 << 18; big_size <= 1 << 28; big_size <<= 2 ){
+        std::vector<int> big(big_size);
+        for( auto i = 0; i < big_size; ++i ){ big[i] = 2*i; }
+        Eytzinger_Index big_index(big.data(), 0, big_size-1);
+
+        std::uniform_int_distribution<int> dist(0, 2*big_size-1);
+        std::vector<int> queries(QUERIES);
+        std::generate(queries.begin(), queries.end(), [&]{ return dist(rng); });
+
+        for( auto q : queries ){
+            if( big_index.search(q) != binary_search(big.data(), q, 0, big_size-1) ){
+                std::cout << "Mismatch for key " << q << std::endl;
+                return 1;
+            }
+        }
+
+        auto binary_ns    = time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, big_size-1); });
+        auto eytzinger_ns = time_per_query(queries, [&](int q){ return big_index.search(q); });
+
+        std::cout << "  " << big_size << "  " << binary_ns << "  " << eytzinger_ns << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <bit>        //std::countr_one
+#include <cstddef>    //std::size_t
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "binary_search.hpp"
+
+// Search index that stores a sorted array in Eytzinger (BFS) order
+// Notes:
+// - Node k has children 2k and 2k+1, the same layout as a binary heap. Index 0 is unused.
+// - The first few levels of the tree sit next to each other in memory, so they stay hot in cache.
+//   A plain sorted array scatters those same probes across the whole table.
+// - The 16 great-great-grandchildren of node k live at [16k, 16k+15]. With 4 byte ints and a
+//   cache line aligned buffer that is exactly one cache line, so we prefetch it 4 levels ahead.
+// - Ranks returned by search() are indices into the original sorted array, so this is a drop-in
+//   replacement for binary_search(a, val, begin, end).
+class Eytzinger_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        std::vector<int, Aligned_Allocator<int>> tree;
+        std::vector<int> ranks;
+        size_type size;
+        int offset;
+
+        // Fill the tree with an in-order walk so the sorted input lands in BFS order
+        size_type build( const int sorted[], size_type i, size_type k ){
+            if( k <= size ){
+                i = build(sorted, i, 2*k);
+                tree[k]  = sorted[i];
+                ranks[k] = offset + static_cast<int>(i);
+                ++i;
+                i = build(sorted, i, 2*k+1);
+            }
+            return i;
+        }
+
+        // Walk down the tree and return the Eytzinger position of the lower bound, or 0 if none
+        // Notes:
+        // - Every step goes left or right based on a single compare, no early exit.
+        // - When we fall out of the tree, k encodes our path. The lower bound is the last node
+        //   where we went left, so we strip the trailing right turns (1 bits) plus that left turn.
+        size_type descend( int val ) const {
+            size_type k = 1;
+            while( k <= size ){
+                search::prefetch(tree.data() + 16*k);
+                k = 2*k + (tree[k] < val);
+            }
+            return k >> (std::countr_one(k) + 1);
+        }
+
+    public:
+        // Build from the inclusive range [begin, end] of a sorted array, same convention as binary_search
+        Eytzinger_Index( const int sorted[], int begin, int end ):
+            size(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0),
+            offset(begin)
+        {
+            tree.resize(size + 1);
+            ranks.resize(size + 1, -1);
+            build(sorted + begin, 0, 1);
+        }
+
+        size_type getSize() const { return size; }
+
+        // Index of the first element >= val in the original array, or end+1 if there is none
+        int lower_bound( int val ) const {
+            size_type k = descend(val);
+            return k == 0 ? offset + static_cast<int>(size) : ranks[k];
+        }
+
+        // Index of val in the original array or -1, matching binary_search
+        int search( int val ) const {
+            size_type k = descend(val);
+            return (k != 0 && tree[k] == val) ? ranks[k] : -1;
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <algorithm>  //std::equal
+#include <ranges>     //std::views::iota, std::views::transform
+#include <random>     //std::mt19937
+#include <vector>
+#include "find_all.hpp"
+#include "sequential_search.hpp"
+#include "benchmark_timer.hpp"
+
+// What callers did before find_all: keep calling sequential_search from just past the last hit
+int rescan_all( const int search_array[], int val, int begin, int end, int out[] ){
+    int count = 0;
+    for( int i = sequential_search(search_array, val, begin, end); i != -1; i = sequential_search(search_array, val, i + 1, end) ){
+        out[count++] = i;
+        if( i == end ){ break; }
+    }
+    return count;
+}
+
+// Reference results for a predicate, one element at a time
+template<class Pred>
+std::vector<int> expected_positions( const std::vector<int>& data, Pred pred, int begin, int end ){
+    std::vector<int> positions;
+    for( int i = begin; i <= end; ++i ){
+        if( pred(data[i]) ){ positions.push_back(i); }
+    }
+    return positions;
+}
+
+int main(){
+
+    int a[] = { 4, 8, 15, 16, 23, 42, 8, 4, 8, 16, 15, 4, 42, 8, 23, 4, 8, 15 };
+    const int SIZE = static_cast<int>(sizeof(a) / sizeof(a[0]));
+    int out[SIZE];
+
+    auto print = [&](const char* name, int count){
+        std::cout << name;
+        for( int i = 0; i < count; ++i ){ std::cout << out[i] << (i + 1 < count ? ", " : ""); }
+        std::cout << std::endl;
+    };
+
+    std::cout << "Dispatching to: " << search::to_string(search::simd_level()) << std::endl;
+    print("8 @ ", find_all(a, 8, 0, SIZE-1, out));
+    print("x < 10 @ ", search::find_all(a, search::Less_Than{ 10 }, 0, SIZE-1, out));
+    print("15 <= x <= 23 @ ", search::find_all(a, search::In_Range{ 15, 23 }, 0, SIZE-1, out));
+    std::cout << "count(4): " << search::count_all(a, search::Equal_To{ 4 }, 0, SIZE-1) << std::endl;
+
+    // Check the dispatched kernels against the one at a time reference
+    // Notes:
+    // - Slide the range bounds so every tail length and starting offset gets exercised.
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> small_values(-8, 8);
+    std::vector<int> data(600);
+    for( auto& e : data ){ e = small_values(rng); }
+    std::vector<int> got(data.size());
+
+    auto check = [&](auto pred, int begin, int end){
+        auto expected = expected_positions(data, pred, begin, end);
+        int count = search::find_all(data.data(), pred, begin, end, got.data());
+        bool ok = count == static_cast<int>(expected.size())
+               && std::equal(expected.begin(), expected.end(), got.begin())
+               && search::count_all(data.data(), pred, begin, end) == count;
+        int scalar_count = search::find_all_scalar(data.data(), pred, begin, end, got.data());
+        ok = ok && scalar_count == count && std::equal(expected.begin(), expected.end(), got.begin());
+#if defined(SEARCH_X86_SIMD)
+        // the dispatcher only runs the widest kernel, so run AVX2 by hand on AVX-512 machines
+        if( search::simd_level() >= search::Simd_Level::avx2 && end >= begin ){
+            int avx2_count = search::find_all_avx2(data.data(), pred, begin, end, got.data());
+            ok = ok && avx2_count == count && std::equal(expected.begin(), expected.end(), got.begin())
+                    && search::count_all_avx2(data.data(), pred, begin, end) == count;
+        }
+#endif
+        return ok;
+    };
+
+    for( int begin = 0; begin < 40; ++begin ){
+        for( int end = begin - 1; end < static_cast<int>(data.size()); end += 23 ){
+            for( int v = -9; v <= 9; v += 3 ){
+                if( !check(search::Equal_To{ v }, begin, end) || !check(search::Less_Than{ v }, begin, end)
+                    || !check(search::In_Range{ v, v + 4 }, begin, end) ){
+                    std::cout << "Mismatch for [" << begin << ", " << end << "] v = " << v << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // Time collecting every hit from an array with a handful of distinct values
+    // Notes:
+    // - One value in 16 matches, so the rescan loop restarts sequential_search every 16 elements or so.
+    const int BIG_SIZE = 1 << 20;
+    const int RUNS = 50;
+    std::uniform_int_distribution<int> sixteen(0, 15);
+    std::vector<int> big(BIG_SIZE);
+    for( auto& e : big ){ e = sixteen(rng); }
+    std::vector<int> positions(BIG_SIZE);
+
+    // Run r looks for the value r % 16
+    auto values = std::views::iota(0, RUNS) | std::views::transform([](int r){ return r % 16; });
+
+    std::cout << std::endl << "Collecting every hit in " << BIG_SIZE << " ints:" << std::endl;
+    std::cout << "  rescan with sequential_search: " << time_per_query(values, [&](int v){ return rescan_all(big.data(), v, 0, BIG_SIZE-1, positions.data()); }) / 1000 << " us" << std::endl;
+    std::cout << "  find_all scalar:               " << time_per_query(values, [&](int v){ return search::find_all_scalar(big.data(), search::Equal_To{ v }, 0, BIG_SIZE-1, positions.data()); }) / 1000 << " us" << std::endl;
+    std::cout << "  find_all:                      " << time_per_query(values, [&](int v){ return find_all(big.data(), v, 0, BIG_SIZE-1, positions.data()); }) / 1000 << " us" << std::endl;
+    std::cout << "  count_all:                     " << time_per_query(values, [&](int v){ return search::count_all(big.data(), search::Equal_To{ v }, 0, BIG_SIZE-1); }) / 1000 << " us" << std::endl;
+    std::cout << "  find_all x < 4:                " << time_per_query(values, [&](int v){ return search::find_all(big.data(), search::Less_Than{ 4 + v % 2 }, 0, BIG_SIZE-1, positions.data()); }) / 1000 << " us" << std::endl;
+
+    return 0;
+}
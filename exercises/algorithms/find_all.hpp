@@ -0,0 +1,237 @@
+#pragma once
+
+#include <array>
+#include <bit>        //std::popcount
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint64_t
+#include <span>       //std::span
+#include "sequential_search.hpp"
+
+// Every matching index in one pass
+// Notes:
+// - Calling sequential_search again from i+1 after every hit rescans and re-dispatches k times.
+//   find_all walks the range once and writes every match position into the caller's buffer.
+// - Vector kernels compare a whole register, then compress the matching lane indices to the front
+//   of a register and store them at out + count. AVX-512 has this as one instruction (vpcompressd).
+//   AVX2 doesn't, so we look up an 8 lane permutation for the 8 bit movemask in a 256 entry table.
+// - The full register store writes past the last match, but never past the end of the buffer:
+//   after scanning i elements we have written at most i positions, so out + count + W <= out + i + W.
+//   Size the buffer for the worst case, one slot per element in the range, and nothing overflows.
+// - The predicate decides what a match is: Equal_To, Less_Than or In_Range. Each one knows how to
+//   test a single value and a whole register so the same kernels serve all three.
+// - SSE2 has no variable shuffle for 32 bit lanes, so on SSE2-only cpus we use the branchless scalar
+//   loop. It stores the index unconditionally and only bumps the count on a match.
+namespace search {
+
+// val == x
+struct Equal_To {
+    int val;
+
+    bool operator()( int x ) const { return x == val; }
+#if defined(SEARCH_X86_SIMD)
+    SEARCH_TARGET("avx2")
+    unsigned int mask( __m256i v ) const {
+        __m256i hit = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(val));
+        return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+    }
+    SEARCH_TARGET("avx512f")
+    __mmask16 mask( __mmask16 lanes, __m512i v ) const {
+        return _mm512_mask_cmpeq_epi32_mask(lanes, v, _mm512_set1_epi32(val));
+    }
+#endif
+};
+
+// x < bound
+struct Less_Than {
+    int bound;
+
+    bool operator()( int x ) const { return x < bound; }
+#if defined(SEARCH_X86_SIMD)
+    SEARCH_TARGET("avx2")
+    unsigned int mask( __m256i v ) const {
+        __m256i hit = _mm256_cmpgt_epi32(_mm256_set1_epi32(bound), v);
+        return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(hit)));
+    }
+    SEARCH_TARGET("avx512f")
+    __mmask16 mask( __mmask16 lanes, __m512i v ) const {
+        return _mm512_mask_cmplt_epi32_mask(lanes, v, _mm512_set1_epi32(bound));
+    }
+#endif
+};
+
+// lo <= x <= hi
+// Notes:
+// - AVX2 only has a greater-than compare, so we flag the values outside the range and flip the mask.
+struct In_Range {
+    int lo;
+    int hi;
+
+    bool operator()( int x ) const { return lo <= x && x <= hi; }
+#if defined(SEARCH_X86_SIMD)
+    SEARCH_TARGET("avx2")
+    unsigned int mask( __m256i v ) const {
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(lo), v), _mm256_cmpgt_epi32(v, _mm256_set1_epi32(hi)));
+        return ~static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(outside))) & 0xFFu;
+    }
+    SEARCH_TARGET("avx512f")
+    __mmask16 mask( __mmask16 lanes, __m512i v ) const {
+        __mmask16 above_lo = _mm512_mask_cmpge_epi32_mask(lanes, v, _mm512_set1_epi32(lo));
+        return _mm512_mask_cmple_epi32_mask(above_lo, v, _mm512_set1_epi32(hi));
+    }
+#endif
+};
+
+// Branchless scalar kernels over the inclusive range [begin, end]
+template<class Pred>
+int find_all_scalar( const int search_array[], Pred pred, int begin, int end, int out[] ){
+    int count = 0;
+    for( int i = begin; i <= end; ++i ){
+        out[count] = i;
+        count += pred(search_array[i]) ? 1 : 0;
+    }
+    return count;
+}
+
+template<class Pred>
+int count_all_scalar( const int search_array[], Pred pred, int begin, int end ){
+    int count = 0;
+    for( int i = begin; i <= end; ++i ){ count += pred(search_array[i]) ? 1 : 0; }
+    return count;
+}
+
+#if defined(SEARCH_X86_SIMD)
+
+// Permutations that move the lanes set in an 8 bit mask to the front, one byte per lane
+// Notes:
+// - Entry m packs the lane numbers of the set bits of m, lowest first. We widen the 8 bytes to
+//   8 ints with vpmovzxbd and feed them to vpermd.
+constexpr std::array<std::uint64_t, 256> COMPRESS_TABLE = []{
+    std::array<std::uint64_t, 256> table{};
+    for( unsigned int m = 0; m < 256; ++m ){
+        std::uint64_t lanes = 0;
+        int slot = 0;
+        for( unsigned int lane = 0; lane < 8; ++lane ){
+            if( (m >> lane) & 1 ){ lanes |= static_cast<std::uint64_t>(lane) << (8 * slot++); }
+        }
+        table[m] = lanes;
+    }
+    return table;
+}();
+
+template<class Pred>
+SEARCH_TARGET("avx2")
+int find_all_avx2( const int search_array[], Pred pred, int begin, int end, int out[] ){
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i index = _mm256_add_epi32(_mm256_set1_epi32(begin), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    int count = 0;
+    int i = begin;
+    for( ; i + 8 <= end + 1; i += 8 ){
+        unsigned int m = pred.mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(search_array + i)));
+        __m256i permute = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&COMPRESS_TABLE[m])));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + count), _mm256_permutevar8x32_epi32(index, permute));
+        count += std::popcount(m);
+        index = _mm256_add_epi32(index, step);
+    }
+
+    return count + find_all_scalar(search_array, pred, i, end, out + count);
+}
+
+// Notes:
+// - Full registers compress in a register and use a plain store. vpcompressd straight to memory is
+//   microcoded and much slower on some cpus (Zen 4). Only the masked tail stores with it.
+template<class Pred>
+SEARCH_TARGET("avx512f")
+int find_all_avx512( const int search_array[], Pred pred, int begin, int end, int out[] ){
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i index = _mm512_add_epi32(_mm512_set1_epi32(begin), _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    int count = 0;
+    int i = begin;
+    for( ; i + 16 <= end + 1; i += 16 ){
+        __mmask16 m = pred.mask(__mmask16(0xFFFF), _mm512_loadu_si512(search_array + i));
+        _mm512_storeu_si512(out + count, _mm512_maskz_compress_epi32(m, index));
+        count += std::popcount(static_cast<unsigned int>(m));
+        index = _mm512_add_epi32(index, step);
+    }
+
+    if( i <= end ){
+        __mmask16 lanes = static_cast<__mmask16>((1u << (end + 1 - i)) - 1);
+        __mmask16 m = pred.mask(lanes, _mm512_maskz_loadu_epi32(lanes, search_array + i));
+        _mm512_mask_compressstoreu_epi32(out + count, m, index);
+        count += std::popcount(static_cast<unsigned int>(m));
+    }
+
+    return count;
+}
+
+template<class Pred>
+SEARCH_TARGET("avx2")
+int count_all_avx2( const int search_array[], Pred pred, int begin, int end ){
+    int count = 0;
+    int i = begin;
+    for( ; i + 8 <= end + 1; i += 8 ){
+        count += std::popcount(pred.mask(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(search_array + i))));
+    }
+
+    return count + count_all_scalar(search_array, pred, i, end);
+}
+
+template<class Pred>
+SEARCH_TARGET("avx512f")
+int count_all_avx512( const int search_array[], Pred pred, int begin, int end ){
+    int count = 0;
+    for( int i = begin; i <= end; i += 16 ){
+        int remaining = end + 1 - i;
+        __mmask16 lanes = remaining >= 16 ? __mmask16(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+        count += std::popcount(static_cast<unsigned int>(pred.mask(lanes, _mm512_maskz_loadu_epi32(lanes, search_array + i))));
+    }
+
+    return count;
+}
+
+#endif
+
+// Write the index of every element of [begin, end] that satisfies pred into out, return how many
+// Notes:
+// - out needs room for end - begin + 1 ints even if only a few match, see the notes at the top.
+template<class Pred>
+int find_all( const int search_array[], Pred pred, int begin, int end, int out[] ){
+    if( end < begin ){ return 0; }
+#if defined(SEARCH_X86_SIMD)
+    Simd_Level level = search::simd_level();
+    if( level == Simd_Level::avx512 ){ return find_all_avx512(search_array, pred, begin, end, out); }
+    if( level == Simd_Level::avx2 ){ return find_all_avx2(search_array, pred, begin, end, out); }
+#endif
+    return find_all_scalar(search_array, pred, begin, end, out);
+}
+
+// Count-only mode: how many elements of [begin, end] satisfy pred, no output buffer needed
+template<class Pred>
+int count_all( const int search_array[], Pred pred, int begin, int end ){
+    if( end < begin ){ return 0; }
+#if defined(SEARCH_X86_SIMD)
+    Simd_Level level = search::simd_level();
+    if( level == Simd_Level::avx512 ){ return count_all_avx512(search_array, pred, begin, end); }
+    if( level == Simd_Level::avx2 ){ return count_all_avx2(search_array, pred, begin, end); }
+#endif
+    return count_all_scalar(search_array, pred, begin, end);
+}
+
+// Span forms, positions are relative to the start of data
+template<class Pred>
+std::size_t find_all( std::span<const int> data, Pred pred, std::span<int> out ){
+    return static_cast<std::size_t>(search::find_all(data.data(), pred, 0, static_cast<int>(data.size()) - 1, out.data()));
+}
+
+template<class Pred>
+std::size_t count_all( std::span<const int> data, Pred pred ){
+    return static_cast<std::size_t>(search::count_all(data.data(), pred, 0, static_cast<int>(data.size()) - 1));
+}
+
+} // namespace search
+
+// Every index of val in the inclusive range [begin, end], written to out. Returns how many there are.
+// Notes:
+// - out must have room for end - begin + 1 ints.
+inline int find_all( const int search_array[], int val, int begin, int end, int out[] ){
+    return search::find_all(search_array, search::Equal_To{ val }, begin, end, out);
+}
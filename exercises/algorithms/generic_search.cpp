@@ -0,0 +1,151 @@
+#include <iostream>
+#include <algorithm>
+#include <ranges>     //std::views::iota
+#include <cstdint>    //std::int64_t
+#include <random>     //std::mt19937_64
+#include <string>
+#include <vector>
+#include "generic_search.hpp"
+#include "benchmark_timer.hpp"
+
+struct Trade {
+    double time;
+    std::int64_t id;
+};
+
+int main(){
+
+    // 64 bit ids way past what an int can hold
+    std::vector<std::int64_t> ids = { 5000000000, 5000000007, 5000000011, 6000000000, 9000000000000 };
+    std::cout << "binary_search(5000000011): " << search::binary_search(ids.data(), ids.size(), std::int64_t(5000000011)) << std::endl;
+    std::cout << "sequential_search(6000000000): " << search::sequential_search(ids.data(), ids.size(), std::int64_t(6000000000)) << std::endl;
+    std::cout << "binary_search(42) == npos: " << std::boolalpha
+              << (search::binary_search(ids.data(), ids.size(), std::int64_t(42)) == search::npos) << std::endl;
+
+    // Search records by one member with a projection
+    std::vector<Trade> trades = { { 0.5, 11 }, { 1.25, 12 }, { 1.25, 13 }, { 3.0, 14 }, { 7.75, 15 } };
+    std::size_t first = search::lower_bound_by(trades.data(), trades.size(), 1.25, {}, &Trade::time);
+    std::size_t last = search::upper_bound_by(trades.data(), trades.size(), 1.25, {}, &Trade::time);
+    std::cout << "trades at t=1.25: [" << first << ", " << last << ")" << std::endl;
+    std::cout << "trade id 14 @ " << search::sequential_search(trades.data(), trades.size(), std::int64_t(14), &Trade::id) << std::endl;
+
+    // Check against the standard library on random data of each key type
+    std::mt19937_64 rng;
+    rng.seed(123456789);
+    for( int trial = 0; trial < 300; ++trial ){
+        std::size_t n = static_cast<std::size_t>(trial) * 7 % 1500;
+        std::vector<std::int64_t> wide(n);
+        std::vector<double> times(n);
+        std::vector<unsigned int> narrow(n);
+        for( std::size_t i = 0; i < n; ++i ){
+            wide[i] = static_cast<std::int64_t>(rng() % 200) << 33;
+            times[i] = static_cast<double>(rng() % 200) * 0.25;
+            narrow[i] = static_cast<unsigned int>(rng() % 200) + 4000000000u;
+        }
+        for( int k = 0; k < 200; k += 3 ){
+            std::int64_t wide_key = static_cast<std::int64_t>(k) << 33;
+            double time_key = k * 0.25;
+            unsigned int narrow_key = static_cast<unsigned int>(k) + 4000000000u;
+            auto expect = [](auto& v, auto key){
+                auto it = std::find(v.begin(), v.end(), key);
+                return it == v.end() ? search::npos : static_cast<std::size_t>(it - v.begin());
+            };
+            bool ok = search::sequential_search(wide.data(), n, wide_key) == expect(wide, wide_key)
+                   && search::sequential_search(times.data(), n, time_key) == expect(times, time_key)
+                   && search::sequential_search(narrow.data(), n, narrow_key) == expect(narrow, narrow_key);
+
+            std::vector<std::int64_t> sorted = wide;
+            std::sort(sorted.begin(), sorted.end());
+            auto lb = static_cast<std::size_t>(std::lower_bound(sorted.begin(), sorted.end(), wide_key) - sorted.begin());
+            auto ub = static_cast<std::size_t>(std::upper_bound(sorted.begin(), sorted.end(), wide_key) - sorted.begin());
+            ok = ok && search::lower_bound_by(sorted.data(), n, wide_key) == lb && search::upper_bound_by(sorted.data(), n, wide_key) == ub
+                    && search::binary_search(sorted.data(), n, wide_key) == (lb < ub ? lb : search::npos);
+            if( !ok ){
+                std::cout << "Mismatch on trial " << trial << " key " << k << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Strings: words sharing long prefixes, short ones, and embedded zero bytes
+    std::vector<std::string> words = { "", "a", std::string("a\0", 2), "ab", "abcdefgh", "abcdefgh", "abcdefghi",
+                                       "abcdefghij", "abcdefgz", "b", "timestamp_2024_01", "timestamp_2024_02", "zebra" };
+    std::sort(words.begin(), words.end());
+    search::String_Prefix_Index word_index(words.data(), words.size());
+    std::vector<std::string> probes = words;
+    for( std::string extra : { std::string("aa"), std::string("abcdefgg"), std::string("abcdefghii"), std::string("timestamp_2024_015"), std::string("zz"), std::string("a\0\0", 3) } ){ probes.push_back(extra); }
+    for( auto& p : probes ){
+        auto expected = static_cast<std::size_t>(std::lower_bound(words.begin(), words.end(), p) - words.begin());
+        if( word_index.lower_bound(p) != expected ){
+            std::cout << "String mismatch for \"" << p << "\"" << std::endl;
+            return 1;
+        }
+    }
+
+    // Same again when every string shares a long start, so the index skips it
+    std::vector<std::string> shared;
+    for( auto& w : words ){ shared.push_back("tenant/0042/" + w); }
+    search::String_Prefix_Index shared_index(shared.data(), shared.size());
+    for( auto& p : probes ){
+        for( std::string q : { "tenant/0042/" + p, "tenant/0041/" + p, "tenant/0043" + p, std::string("tenant/00").append(p) } ){
+            auto expected = static_cast<std::size_t>(std::lower_bound(shared.begin(), shared.end(), q) - shared.begin());
+            if( shared_index.lower_bound(q) != expected ){
+                std::cout << "String mismatch for \"" << q << "\"" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "String_Prefix_Index search(abcdefghi): " << word_index.search("abcdefghi") << std::endl;
+
+    // Timing
+    const std::size_t BIG = 1 << 22;
+    const int QUERIES = 1 << 20;
+
+    // Sorted int and int64 tables of the same length take the same branchless path
+    std::vector<int> small_keys(BIG);
+    std::vector<std::int64_t> wide_keys(BIG);
+    for( std::size_t i = 0; i < BIG; ++i ){
+        small_keys[i] = static_cast<int>(2 * i);
+        wide_keys[i] = static_cast<std::int64_t>(2 * i) << 20;
+    }
+    std::vector<std::size_t> picks(QUERIES);
+    for( auto& p : picks ){ p = rng() % BIG; }
+
+    std::cout << std::endl << "binary search, " << BIG << " keys:" << std::endl;
+    std::cout << "  int binary_search:           "
+              << time_per_query(picks, [&](std::size_t p){ return binary_search(small_keys.data(), small_keys[p], 0, static_cast<int>(BIG)-1); }) << " ns/lookup" << std::endl;
+    std::cout << "  search::binary_search int64: "
+              << time_per_query(picks, [&](std::size_t p){ return search::binary_search(wide_keys.data(), BIG, wide_keys[p]); }) << " ns/lookup" << std::endl;
+
+    const int SCANS = 256;
+    const std::size_t SCAN_SIZE = 1 << 16;
+    std::cout << std::endl << "sequential search, " << SCAN_SIZE << " keys, all misses:" << std::endl;
+    auto scans = std::views::iota(0, SCANS);
+    std::cout << "  int sequential_search:           "
+              << time_per_query(scans, [&](int q){ return sequential_search(small_keys.data(), -1 - q, 0, static_cast<int>(SCAN_SIZE)-1); }) << " ns/lookup" << std::endl;
+    std::cout << "  search::sequential_search int64: "
+              << time_per_query(scans, [&](int q){ return search::sequential_search(wide_keys.data(), SCAN_SIZE, std::int64_t(-1 - q)); }) << " ns/lookup" << std::endl;
+    std::cout << "  plain loop over int64:           "
+              << time_per_query(scans, [&](int q){
+                     return search::sequential_search(wide_keys.data(), SCAN_SIZE, std::int64_t(-1 - q), [](std::int64_t v){ return v; });
+                 }) << " ns/lookup" << std::endl;
+
+    // Keys with a common namespace, like "user:<id>:profile"
+    std::vector<std::string> names(1 << 20);
+    for( std::size_t i = 0; i < names.size(); ++i ){
+        names[i] = "user:" + std::to_string(rng() % 1000000000000ull) + ":profile";
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    search::String_Prefix_Index name_index(names.data(), names.size());
+    std::vector<std::string> name_queries(QUERIES);
+    for( auto& q : name_queries ){ q = names[rng() % names.size()]; }
+
+    std::cout << std::endl << "string lookups, " << names.size() << " keys, " << name_index.getCommonLength() << " shared bytes skipped:" << std::endl;
+    std::cout << "  std::lower_bound on strings: "
+              << time_per_query(name_queries, [&](const std::string& q){ return std::lower_bound(names.begin(), names.end(), q) - names.begin(); }) << " ns/lookup" << std::endl;
+    std::cout << "  String_Prefix_Index:         "
+              << time_per_query(name_queries, [&](const std::string& q){ return name_index.search(q); }) << " ns/lookup" << std::endl;
+
+    return 0;
+}
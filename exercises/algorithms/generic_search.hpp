@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>  //std::min
+#include <bit>        //std::countr_zero
+#include <climits>    //INT_MAX
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint64_t, SIZE_MAX
+#include <cstring>    //std::memcpy
+#include <functional> //std::identity, std::invoke, std::less
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "binary_search.hpp"
+#include "sequential_search.hpp"
+
+// Searches over any key type with size_t positions
+// Notes:
+// - The int versions (binary_search, sequential_search) take int bounds, so they top out at 2^31
+//   elements and only take int keys. These take a pointer and a size_t length instead.
+// - Arguments follow std::ranges: the key, then a comparator, then a projection. The projection picks
+//   the key out of each element, so an array of records can be searched by one member:
+//     search::binary_search(trades, n, t, {}, &Trade::time)
+// - Positions are size_t. A miss returns search::npos.
+// - With the default comparator and projection the binary searches compile to the same branchless
+//   loop as the int path. sequential_search sends 32 bit, 64 bit integer and double keys to SIMD kernels.
+namespace search {
+
+constexpr std::size_t npos = SIZE_MAX;
+
+// Branchless lower and upper bound on the projected keys
+template<class T, class Key, class Compare = std::less<>, class Proj = std::identity>
+constexpr std::size_t lower_bound_by( const T* data, std::size_t n, const Key& key, Compare comp = Compare{}, Proj proj = Proj{} ){
+    if( n == 0 ){ return 0; }
+
+    const T* base = data;
+    while( n > 1 ){
+        std::size_t half = n / 2;
+        search::prefetch(base + half / 2);
+        search::prefetch(base + half + half / 2);
+        base = comp(std::invoke(proj, base[half]), key) ? base + half : base;
+        n -= half;
+    }
+
+    return static_cast<std::size_t>(base - data) + comp(std::invoke(proj, *base), key);
+}
+
+template<class T, class Key, class Compare = std::less<>, class Proj = std::identity>
+constexpr std::size_t upper_bound_by( const T* data, std::size_t n, const Key& key, Compare comp = Compare{}, Proj proj = Proj{} ){
+    if( n == 0 ){ return 0; }
+
+    const T* base = data;
+    while( n > 1 ){
+        std::size_t half = n / 2;
+        search::prefetch(base + half / 2);
+        search::prefetch(base + half + half / 2);
+        base = comp(key, std::invoke(proj, base[half])) ? base : base + half;
+        n -= half;
+    }
+
+    return static_cast<std::size_t>(base - data) + !comp(key, std::invoke(proj, *base));
+}
+
+// Position of the first element whose projected key is equivalent to key, or npos
+template<class T, class Key, class Compare = std::less<>, class Proj = std::identity>
+constexpr std::size_t binary_search( const T* data, std::size_t n, const Key& key, Compare comp = Compare{}, Proj proj = Proj{} ){
+    std::size_t i = search::lower_bound_by(data, n, key, comp, proj);
+    if( i < n && !comp(key, std::invoke(proj, data[i])) ){ return i; }
+    return npos;
+}
+
+#if defined(SEARCH_X86_SIMD)
+
+// 64 bit equality kernels, same shape as the 32 bit ones: 4 registers per iteration, one branch
+SEARCH_TARGET("avx2")
+inline std::size_t sequential_search_avx2_i64( const std::int64_t* data, std::size_t n, std::int64_t val ){
+    const __m256i key = _mm256_set1_epi64x(val);
+    std::size_t i = 0;
+    for( ; i + 16 <= n; i += 16 ){
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + i);
+        __m256i c0 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 0), key);
+        __m256i c1 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 1), key);
+        __m256i c2 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 2), key);
+        __m256i c3 = _mm256_cmpeq_epi64(_mm256_loadu_si256(p + 3), key);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        if( !_mm256_testz_si256(any, any) ){
+            unsigned int m = static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(c0)))
+                           | static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(c1))) << 4
+                           | static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(c2))) << 8
+                           | static_cast<unsigned int>(_mm256_movemask_pd(_mm256_castsi256_pd(c3))) << 12;
+            return i + static_cast<std::size_t>(std::countr_zero(m));
+        }
+    }
+    for( ; i < n; ++i ){
+        if( data[i] == val ){ return i; }
+    }
+    return npos;
+}
+
+SEARCH_TARGET("avx512f")
+inline std::size_t sequential_search_avx512_i64( const std::int64_t* data, std::size_t n, std::int64_t val ){
+    const __m512i key = _mm512_set1_epi64(val);
+    std::size_t i = 0;
+    for( ; i + 32 <= n; i += 32 ){
+        const std::int64_t* p = data + i;
+        unsigned int m = static_cast<unsigned int>(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(p +  0), key))
+                       | static_cast<unsigned int>(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(p +  8), key)) << 8
+                       | static_cast<unsigned int>(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(p + 16), key)) << 16
+                       | static_cast<unsigned int>(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(p + 24), key)) << 24;
+        if( m != 0 ){ return i + static_cast<std::size_t>(std::countr_zero(m)); }
+    }
+    for( ; i < n; i += 8 ){
+        std::size_t remaining = n - i;
+        __mmask8 lanes = remaining >= 8 ? __mmask8(0xFF) : static_cast<__mmask8>((1u << remaining) - 1);
+        unsigned int m = _mm512_mask_cmpeq_epi64_mask(lanes, _mm512_maskz_loadu_epi64(lanes, data + i), key);
+        if( m != 0 ){ return i + static_cast<std::size_t>(std::countr_zero(m)); }
+    }
+    return npos;
+}
+
+// Doubles compare with ==, not bitwise: 0.0 finds -0.0 and NaN finds nothing
+SEARCH_TARGET("avx2")
+inline std::size_t sequential_search_avx2_f64( const double* data, std::size_t n, double val ){
+    const __m256d key = _mm256_set1_pd(val);
+    std::size_t i = 0;
+    for( ; i + 16 <= n; i += 16 ){
+        const double* p = data + i;
+        __m256d c0 = _mm256_cmp_pd(_mm256_loadu_pd(p +  0), key, _CMP_EQ_OQ);
+        __m256d c1 = _mm256_cmp_pd(_mm256_loadu_pd(p +  4), key, _CMP_EQ_OQ);
+        __m256d c2 = _mm256_cmp_pd(_mm256_loadu_pd(p +  8), key, _CMP_EQ_OQ);
+        __m256d c3 = _mm256_cmp_pd(_mm256_loadu_pd(p + 12), key, _CMP_EQ_OQ);
+        unsigned int m = static_cast<unsigned int>(_mm256_movemask_pd(c0))
+                       | static_cast<unsigned int>(_mm256_movemask_pd(c1)) << 4
+                       | static_cast<unsigned int>(_mm256_movemask_pd(c2)) << 8
+                       | static_cast<unsigned int>(_mm256_movemask_pd(c3)) << 12;
+        if( m != 0 ){ return i + static_cast<std::size_t>(std::countr_zero(m)); }
+    }
+    for( ; i < n; ++i ){
+        if( data[i] == val ){ return i; }
+    }
+    return npos;
+}
+
+SEARCH_TARGET("avx512f")
+inline std::size_t sequential_search_avx512_f64( const double* data, std::size_t n, double val ){
+    const __m512d key = _mm512_set1_pd(val);
+    std::size_t i = 0;
+    for( ; i + 32 <= n; i += 32 ){
+        const double* p = data + i;
+        unsigned int m = static_cast<unsigned int>(_mm512_cmp_pd_mask(_mm512_loadu_pd(p +  0), key, _CMP_EQ_OQ))
+                       | static_cast<unsigned int>(_mm512_cmp_pd_mask(_mm512_loadu_pd(p +  8), key, _CMP_EQ_OQ)) << 8
+                       | static_cast<unsigned int>(_mm512_cmp_pd_mask(_mm512_loadu_pd(p + 16), key, _CMP_EQ_OQ)) << 16
+                       | static_cast<unsigned int>(_mm512_cmp_pd_mask(_mm512_loadu_pd(p + 24), key, _CMP_EQ_OQ)) << 24;
+        if( m != 0 ){ return i + static_cast<std::size_t>(std::countr_zero(m)); }
+    }
+    for( ; i < n; i += 8 ){
+        std::size_t remaining = n - i;
+        __mmask8 lanes = remaining >= 8 ? __mmask8(0xFF) : static_cast<__mmask8>((1u << remaining) - 1);
+        unsigned int m = _mm512_mask_cmp_pd_mask(lanes, _mm512_maskz_loadu_pd(lanes, data + i), key, _CMP_EQ_OQ);
+        if( m != 0 ){ return i + static_cast<std::size_t>(std::countr_zero(m)); }
+    }
+    return npos;
+}
+
+#endif
+
+// Position of the first element whose projected key == key, or npos
+// Notes:
+// - With no projection and a key of the element type, 32 and 64 bit integers and doubles go to the
+//   SIMD kernels. 32 bit arrays reuse the int kernels a billion elements at a time, so they work
+//   past 2^31 elements too. Everything else runs the plain loop.
+template<class T, class Key, class Proj = std::identity>
+std::size_t sequential_search( const T* data, std::size_t n, const Key& key, Proj proj = Proj{} ){
+    if constexpr( std::is_same_v<Proj, std::identity> && std::is_same_v<std::remove_cv_t<Key>, T> ){
+        if constexpr( std::is_integral_v<T> && sizeof(T) == sizeof(int) ){
+            static const Search_Kernel kernel = search::pick_search_kernel(search::simd_level());
+            // signed and unsigned 32 bit ints may alias, and integer equality is bit equality
+            const int* ints = reinterpret_cast<const int*>(data);
+            int val = static_cast<int>(key);
+            const std::size_t CHUNK = std::size_t(1) << 30;
+            for( std::size_t first = 0; first < n; first += CHUNK ){
+                int last = static_cast<int>(std::min(n - first, CHUNK)) - 1;
+                int found = kernel(ints + first, val, 0, last);
+                if( found != -1 ){ return first + static_cast<std::size_t>(found); }
+            }
+            return npos;
+        }
+#if defined(SEARCH_X86_SIMD)
+        if constexpr( std::is_integral_v<T> && sizeof(T) == sizeof(std::int64_t) ){
+            const std::int64_t* wide = reinterpret_cast<const std::int64_t*>(data);
+            std::int64_t val = static_cast<std::int64_t>(key);
+            if( search::simd_level() == Simd_Level::avx512 ){ return sequential_search_avx512_i64(wide, n, val); }
+            if( search::simd_level() == Simd_Level::avx2 ){ return sequential_search_avx2_i64(wide, n, val); }
+        }
+        if constexpr( std::is_same_v<T, double> ){
+            if( search::simd_level() == Simd_Level::avx512 ){ return sequential_search_avx512_f64(data, n, key); }
+            if( search::simd_level() == Simd_Level::avx2 ){ return sequential_search_avx2_f64(data, n, key); }
+        }
+#endif
+    }
+
+    for( std::size_t i = 0; i < n; ++i ){
+        if( std::invoke(proj, data[i]) == key ){ return i; }
+    }
+    return npos;
+}
+
+// Sorted strings with a fixed width prefix key next to each one
+// Notes:
+// - Comparing std::strings means following a pointer (or reading the small string buffer) and a
+//   memcmp. Most of the time a few bytes already decide the order.
+// - Keys often share a long common start ("user:...", "2024-01-..."). Since the array is sorted, the
+//   part every string shares is the common prefix of the first and last string. We check a query
+//   against that once and build the prefix keys from the bytes right after it.
+// - The prefix key is the next 8 bytes as a big endian uint64, padded with zero bytes. Comparing two of
+//   those as integers orders them exactly like those bytes of the strings, and padding with the
+//   smallest byte keeps shorter strings in front. So the prefix keys are sorted whenever the strings are.
+// - A lookup runs the branchless search over the flat uint64 array (8 per cache line, no pointers),
+//   then compares whole strings only inside the run of equal prefix keys. When the keys differ within
+//   those 8 bytes the run has a single entry and we touch exactly one string.
+// - The strings aren't copied. Keep the array alive and unchanged while the index is in use.
+class String_Prefix_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        const std::string* strings;
+        size_type count;
+        std::string common;
+        std::vector<std::uint64_t> prefixes;
+
+        // 8 bytes of s starting after the common part
+        std::uint64_t prefixKey( std::string_view s ) const {
+            s.remove_prefix(common.size() < s.size() ? common.size() : s.size());
+            unsigned char bytes[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            std::memcpy(bytes, s.data(), s.size() < 8 ? s.size() : 8);
+            std::uint64_t p = 0;
+            for( int b = 0; b < 8; ++b ){ p = (p << 8) | bytes[b]; }
+            return p;
+        }
+
+    public:
+        String_Prefix_Index( const std::string* sorted, size_type n ):
+            strings(sorted),
+            count(n)
+        {
+            if( n > 0 ){
+                const std::string& first = sorted[0];
+                const std::string& last = sorted[n - 1];
+                size_type shared = 0;
+                while( shared < first.size() && shared < last.size() && first[shared] == last[shared] ){ ++shared; }
+                common = first.substr(0, shared);
+            }
+            prefixes.resize(n);
+            for( size_type i = 0; i < n; ++i ){ prefixes[i] = prefixKey(sorted[i]); }
+        }
+
+        size_type getSize() const { return count; }
+        size_type getCommonLength() const { return common.size(); }
+
+        // Position of the first string not less than key, or getSize()
+        size_type lower_bound( std::string_view key ) const {
+            // every string starts with `common`, so a key that doesn't sorts before or after all of them
+            std::string_view head = key.substr(0, common.size());
+            int order = head.compare(std::string_view(common).substr(0, head.size()));
+            if( order < 0 || (order == 0 && key.size() < common.size()) ){ return 0; }
+            if( order > 0 ){ return count; }
+
+            Bound_Pair run = search::equal_range(prefixes.data(), count, prefixKey(key));
+            // every string before the run is smaller and every one after it is bigger
+            if( run.lower == run.upper ){ return run.lower; }
+            return run.lower + search::lower_bound_by(strings + run.lower, run.upper - run.lower, key, std::less<>{},
+                                                      [](const std::string& s){ return std::string_view(s); });
+        }
+
+        // Position of key or npos
+        size_type search( std::string_view key ) const {
+            size_type i = lower_bound(key);
+            if( i < count && strings[i] == key ){ return i; }
+            return npos;
+        }
+
+        bool contains( std::string_view key ) const { return search(key) != npos; }
+};
+
+} // namespace search
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>    //INT_MIN, INT_MAX
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "interpolation_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with linear increasing values. The best case for interpolation.
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = i;
+    }
+
+    auto found = interpolation_search(a, a[SIZE/4], 0, SIZE-1);
+    std::cout << "Searching for: " << a[SIZE/4] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
+
+    // Build a few big tables with very different key distributions
+    // Notes:
+    // - uniform: random keys spread evenly over the whole int range
+    // - linear:  a[i] = i like above
+    // - skewed:  most keys bunched up at the front with a long sparse tail, the worst case for guessing
+    // - extreme: keys at INT_MIN and INT_MAX to make sure the estimate can't overflow
+    const int BIG_SIZE = 1 << 22;
+    const int QUERIES  = 1 << 20;
+    std::mt19937 rng;
+    rng.seed(123456789);
+
+    std::vector<int> uniform(BIG_SIZE), linear(BIG_SIZE), skewed(BIG_SIZE), extreme(BIG_SIZE);
+    std::uniform_int_distribution<int> any_int(INT_MIN, INT_MAX);
+    std::generate(uniform.begin(), uniform.end(), [&]{ return any_int(rng); });
+    std::sort(uniform.begin(), uniform.end());
+    for( auto i = 0; i < BIG_SIZE; ++i ){
+        linear[i] = i;
+        double x = static_cast<double>(i) / BIG_SIZE;
+        skewed[i] = static_cast<int>(x * x * x * x * x * x * x * x * 2000000000.0);
+        extreme[i] = i < BIG_SIZE/2 ? INT_MIN + i : INT_MAX - (BIG_SIZE - 1 - i);
+    }
+
+    struct Table { const char* name; std::vector<int>* data; };
+    Table tables[] = { { "uniform", &uniform }, { "linear", &linear }, { "skewed", &skewed }, { "extreme", &extreme } };
+
+    std::cout << std::endl << "  table    binary ns  interpolation ns" << std::endl;
+    for( auto& table : tables ){
+        auto& data = *table.data;
+
+        // half the queries are keys from the table, the rest are random
+        std::vector<int> queries(QUERIES);
+        std::uniform_int_distribution<int> pick(0, BIG_SIZE-1);
+        for( auto q = 0; q < QUERIES; ++q ){ queries[q] = q % 2 ? data[pick(rng)] : any_int(rng); }
+
+        for( auto q : queries ){
+            if( interpolation_search(data.data(), q, 0, BIG_SIZE-1) != binary_search(data.data(), q, 0, BIG_SIZE-1) ){
+                std::cout << "Mismatch in " << table.name << " for key " << q << std::endl;
+                return 1;
+            }
+        }
+
+        auto binary_ns        = time_per_query(queries, [&](int q){ return binary_search(data.data(), q, 0, BIG_SIZE-1); });
+        auto interpolation_ns = time_per_query(queries, [&](int q){ return interpolation_search(data.data(), q, 0, BIG_SIZE-1); });
+        std::cout << "  " << table.name << "  " << binary_ns << "  " << interpolation_ns << std::endl;
+    }
+
+    return 0;
+}
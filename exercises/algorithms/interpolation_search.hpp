@@ -0,0 +1,99 @@
+#pragma once
+
+#include <bit>        //std::bit_width
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::int64_t
+#include "binary_search.hpp"
+
+namespace search {
+
+// Interpolation lower bound over a sorted int array
+// Notes:
+// - Returns the first index i in [0, n) with data[i] >= key, or n. Same answer as search::lower_bound.
+// - Instead of probing the middle we guess where the key should be, assuming the keys between the
+//   two ends of the range are spread evenly: pos = lo + (key - a[lo]) * (hi - lo) / (a[hi] - a[lo]).
+//   On uniform keys the guess is off by about sqrt(range), so the range shrinks from n to sqrt(n)
+//   per step and we need O(log log n) probes.
+// - The key differences can need 33 bits and the product with the range length more than 64, so the
+//   estimate is done in double and clamped back into the range. Nothing can overflow.
+// - After each guess we take a second "guard" probe sqrt(range) away on the other side. When the guess
+//   was good the key ends up bracketed between the two probes. We prefetch both possible guards so
+//   the guard costs no extra round trip to memory.
+// - Which side of the guess the key lands on is a coin flip, so the guess and its guard only feed
+//   selects. Branching on them mispredicts about once per step and loses to binary_search on uniform
+//   random keys.
+// - Guessing only pays while the range is big. The double divide sits on the critical path of every
+//   step, so once the bracket is down to INTERPOLATION_STOP elements we let bisection finish.
+// - If a step fails to at least halve the range the keys are not uniform enough for guessing to pay
+//   off. We throw the bracket away and bisect the whole array: its top levels are shared by every
+//   lookup and stay in cache, the levels of an odd bracket don't.
+inline constexpr std::size_t INTERPOLATION_STOP = 1024;
+
+inline std::size_t interpolation_lower_bound( const int* data, std::size_t n, int key ){
+    if( n == 0 || key <= data[0] ){ return 0; }
+    if( key > data[n-1] ){ return n; }
+
+    // Invariant: left_val = data[left] < key <= data[right] = right_val, so the answer is in (left, right]
+    // Notes:
+    // - We interpolate between the values we already probed, so after the first two (hot) loads
+    //   every step only touches the guess and its guard.
+    // - A guard that would fall outside the bracket is clamped onto its end, whose value we know, so
+    //   probing it changes nothing and needs no branch.
+    std::size_t left  = 0;
+    std::size_t right = n - 1;
+    std::int64_t left_val  = data[left];
+    std::int64_t right_val = data[right];
+
+    while( right - left > INTERPOLATION_STOP ){
+        std::size_t size = right - left;
+        double num  = static_cast<double>(key - left_val);
+        double den  = static_cast<double>(right_val - left_val);
+        std::size_t pos = left + static_cast<std::size_t>(num * static_cast<double>(size) / den);
+        pos = pos <= left ? left + 1 : pos;
+        pos = pos >= right ? right - 1 : pos;
+
+        // guard distance is roughly sqrt(size), rounded to a power of two
+        std::size_t guard = std::size_t(1) << (std::bit_width(size) / 2);
+        std::size_t up    = pos + guard < right ? pos + guard : right;
+        std::size_t down  = pos > left + guard ? pos - guard : left;
+
+        // Both guard addresses are known before we read data[pos], so start all three loads together
+        search::prefetch(data + up);
+        search::prefetch(data + down);
+
+        std::int64_t pos_val = data[pos];
+        bool below = pos_val < key;
+        left  = below ? pos : left;
+        left_val  = below ? pos_val : left_val;
+        right = below ? right : pos;
+        right_val = below ? right_val : pos_val;
+
+        std::size_t g = below ? up : down;
+        std::int64_t g_val = data[g];
+        bool g_below = g_val < key;
+        left  = g_below ? g : left;
+        left_val  = g_below ? g_val : left_val;
+        right = g_below ? right : g;
+        right_val = g_below ? right_val : g_val;
+
+        // Not converging, let bisection over the whole array do the job
+        if( right - left > size / 2 ){ return search::lower_bound(data, n, key); }
+    }
+
+    return left + 1 + search::lower_bound(data + left + 1, right - left - 1, key);
+}
+
+} // namespace search
+
+// Interpolation search over the inclusive range [begin, end]
+// Notes:
+// - Same contract as binary_search: index of the first occurrence of val, or -1.
+inline int interpolation_search( const int search_array[], int val, int begin, int end ){
+    if( end < begin ){ return -1; }
+
+    std::size_t n = static_cast<std::size_t>(end - begin) + 1;
+    std::size_t i = search::interpolation_lower_bound(search_array + begin, n, val);
+
+    if( i < n && search_array[begin + i] == val ){ return begin + static_cast<int>(i); }
+    return -1;
+}
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "learned_index.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with linear increasing values. One segment covers all of it.
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = i;
+    }
+
+    Learned_Index index(a, 0, SIZE-1);
+    auto found = index.search(a[SIZE/4]);
+    std::cout << "Searching for: " << a[SIZE/4] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "] using " << index.getSegmentCount() << " segment(s)" << std::endl;
+
+    // Random sorted keys with runs of duplicates, checked against binary_search for hits and misses
+    std::mt19937 rng;
+    rng.seed(123456789);
+    for( int n : { 1, 2, 100, 5000 } ){
+        std::vector<int> data(n);
+        std::uniform_int_distribution<int> small(0, 3*n);
+        std::generate(data.begin(), data.end(), [&]{ return small(rng); });
+        std::sort(data.begin(), data.end());
+        for( std::size_t eps : { 0, 1, 4, 32 } ){
+            Learned_Index tree(data.data(), 0, n-1, eps);
+            for( int val = -1; val <= 3*n + 1; ++val ){
+                if( tree.search(val) != binary_search(data.data(), val, 0, n-1) ){
+                    std::cout << "Mismatch for n = " << n << " eps = " << eps << " key " << val << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // A big table of random keys. The model is a tiny fraction of the data.
+    const int BIG_SIZE = 1 << 24;
+    const int QUERIES  = 1 << 20;
+    std::vector<int> big(BIG_SIZE);
+    std::uniform_int_distribution<int> any_key(0, 1 << 30);
+    std::generate(big.begin(), big.end(), [&]{ return any_key(rng); });
+    std::sort(big.begin(), big.end());
+
+    std::vector<int> queries(QUERIES);
+    std::uniform_int_distribution<int> pick(0, BIG_SIZE-1);
+    for( auto q = 0; q < QUERIES; ++q ){ queries[q] = q % 2 ? big[pick(rng)] : any_key(rng); }
+
+    std::cout << std::endl << "Table: " << BIG_SIZE << " keys, " << BIG_SIZE * sizeof(int) / 1024 << " KB" << std::endl;
+    std::cout << "  binary search: " << time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, BIG_SIZE-1); }) << " ns/lookup" << std::endl;
+    for( std::size_t eps : { 16, 64, 256 } ){
+        Learned_Index learned(big.data(), 0, BIG_SIZE-1, eps);
+        for( auto q : queries ){
+            if( learned.search(q) != binary_search(big.data(), q, 0, BIG_SIZE-1) ){
+                std::cout << "Mismatch for key " << q << std::endl;
+                return 1;
+            }
+        }
+        std::cout << "  eps " << eps << ": " << learned.getSegmentCount() << " segments, "
+                  << learned.getModelBytes() / 1024 << " KB model, "
+                  << time_per_query(queries, [&](int q){ return learned.search(q); }) << " ns/lookup" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>    //std::size_t
+#include <limits>     //std::numeric_limits
+#include <vector>
+#include "binary_search.hpp"
+#include "exponential_search.hpp"
+
+// Learned index over a sorted int array (a single level PGM style model)
+// Notes:
+// - The keys are covered by line segments. Segment s starts at key first_key[s], which sits at
+//   position first_pos[s], and predicts pos(key) = first_pos[s] + slope[s] * (key - first_key[s]).
+// - Segments are fitted so that every distinct key is predicted within +-epsilon of its first
+//   occurrence. A lookup finds its segment with a binary search over the (small, cache resident)
+//   segment keys, evaluates the line and then only has to bisect a window of 2*epsilon+3 slots.
+//   That window spans a handful of cache lines. We prefetch all of them up front so they arrive
+//   together, which makes a cold lookup cost about one or two misses.
+// - Building is one pass with the "shrinking cone": each new key narrows the range of slopes that
+//   keep all points of the segment within epsilon. When the cone closes we start a new segment.
+// - Keys that aren't in the table (and heavy duplicates) can fall just outside the window. We check
+//   the answer against its neighbours and, in that rare case, gallop from the window edge, so the
+//   result is always exactly search::lower_bound and never an approximation.
+// - The model is a few numbers per segment. For smooth key sets that is a tiny fraction of the data.
+class Learned_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        const int* data;
+        size_type size;
+        size_type epsilon;
+        int offset;
+
+        std::vector<int> first_key;
+        std::vector<size_type> first_pos;
+        std::vector<double> slope;
+
+        void build(){
+            const double eps = static_cast<double>(epsilon);
+            size_type i = 0;
+            while( i < size ){
+                const int k0 = data[i];
+                const size_type p0 = i;
+                double slope_lo = 0.0;
+                double slope_hi = std::numeric_limits<double>::infinity();
+
+                // only the first occurrence of a key matters for a lower bound
+                size_type j = i + 1;
+                while( j < size && data[j] == k0 ){ ++j; }
+
+                while( j < size ){
+                    double dx = static_cast<double>(data[j]) - static_cast<double>(k0);
+                    double dy = static_cast<double>(j - p0);
+                    double smin = (dy - eps) / dx;
+                    double smax = (dy + eps) / dx;
+                    if( smin > slope_hi || smax < slope_lo ){ break; }
+
+                    if( smin > slope_lo ){ slope_lo = smin; }
+                    if( smax < slope_hi ){ slope_hi = smax; }
+
+                    int k = data[j];
+                    while( j < size && data[j] == k ){ ++j; }
+                }
+
+                first_key.push_back(k0);
+                first_pos.push_back(p0);
+                slope.push_back(slope_hi == std::numeric_limits<double>::infinity() ? 0.0 : (slope_lo + slope_hi) / 2);
+                i = j;
+            }
+        }
+
+        // First position in the table (relative to begin) holding a key >= val
+        size_type lower_bound_pos( int val ) const {
+            if( size == 0 ){ return 0; }
+
+            // Last segment starting at or before val. Keys below the first segment predict 0.
+            size_type s = search::upper_bound(first_key.data(), first_key.size(), val);
+            if( s == 0 ){ return 0; }
+            --s;
+
+            double predicted = static_cast<double>(first_pos[s])
+                             + slope[s] * (static_cast<double>(val) - static_cast<double>(first_key[s]));
+            double max_pos = static_cast<double>(size);
+            if( predicted < 0 ){ predicted = 0; }
+            if( predicted > max_pos ){ predicted = max_pos; }
+
+            size_type guess = static_cast<size_type>(predicted);
+            size_type lo = guess > epsilon + 1 ? guess - epsilon - 1 : 0;
+            size_type hi = guess + epsilon + 2 < size ? guess + epsilon + 2 : size;
+
+            // The window lines are independent loads, so ask for all of them before we start bisecting
+            for( size_type p = lo; p < hi; p += 64 / sizeof(int) ){ search::prefetch(data + p); }
+            size_type pos = lo + search::lower_bound(data + lo, hi - lo, val);
+
+            // The window was right unless the answer sits on an edge whose far side disagrees
+            if( pos == lo && lo > 0 && data[lo-1] >= val ){
+                return search::gallop_backward(data, size, val, lo);
+            }
+            if( pos == hi && hi < size && data[hi] < val ){
+                return search::gallop_forward(data, size, val, hi);
+            }
+            return pos;
+        }
+
+    public:
+        // Build over the inclusive range [begin, end] of a sorted array, same convention as binary_search
+        // Notes:
+        // - The index keeps a pointer to the array, it does not copy it. Keep the array alive.
+        Learned_Index( const int sorted[], int begin, int end, size_type epsilon = 32 ):
+            data(sorted + begin),
+            size(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0),
+            epsilon(epsilon),
+            offset(begin)
+        {
+            build();
+        }
+
+        size_type getSize() const { return size; }
+        size_type getEpsilon() const { return epsilon; }
+        size_type getSegmentCount() const { return first_key.size(); }
+
+        // Bytes used by the model, not counting the table itself
+        size_type getModelBytes() const {
+            return first_key.size() * (sizeof(int) + sizeof(size_type) + sizeof(double));
+        }
+
+        // Index of the first element >= val in the original array, or end+1 if there is none
+        int lower_bound( int val ) const {
+            return offset + static_cast<int>(lower_bound_pos(val));
+        }
+
+        // Index of val in the original array or -1, matching binary_search
+        int search( int val ) const {
+            size_type pos = lower_bound_pos(val);
+            if( pos < size && data[pos] == val ){ return offset + static_cast<int>(pos); }
+            return -1;
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
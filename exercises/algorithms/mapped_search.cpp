@@ -0,0 +1,68 @@
+#include <iostream>
+#include <algorithm>
+#include <filesystem> //std::filesystem::temp_directory_path
+#include <optional>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "mapped_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    // Build a sorted key set in memory and write it out, 16M keys is a 64MB file
+    const int SIZE = 1 << 24;
+    const int QUERIES = 1 << 20;
+    std::vector<int> keys(SIZE);
+
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> any_key(0, 1 << 30);
+    std::generate(keys.begin(), keys.end(), [&]{ return any_key(rng); });
+    std::sort(keys.begin(), keys.end());
+
+    // Note: use a try catch block since IO operations can fail easily
+    std::string filename = (std::filesystem::temp_directory_path() / "sorted_keys.bin").string();
+    try{
+        write_sorted_key_file(filename, keys.data(), keys.size());
+    } catch(std::exception &e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << std::filesystem::file_size(filename) / (1024*1024) << " MB to " << filename << std::endl;
+
+    // Unsorted input is rejected
+    int unsorted[] = { 3, 1, 2 };
+    try{
+        write_sorted_key_file(filename + ".bad", unsorted, 3);
+    } catch( const std::invalid_argument& e ) {
+        std::cout << "Caught the Invalid Argument!" << std::endl;
+        std::cout << e.what() << std::endl;
+    }
+
+    std::vector<int> queries(QUERIES);
+    std::uniform_int_distribution<int> pick(0, SIZE-1);
+    for( auto q = 0; q < QUERIES; ++q ){ queries[q] = q % 2 ? keys[pick(rng)] : any_key(rng); }
+
+    for( bool load_sample : { false, true } ){
+        std::optional<Mapped_Key_File> opened;
+        double open_ns = time_ns([&]{ opened.emplace(filename, load_sample); });
+        const Mapped_Key_File& file = *opened;
+
+        for( auto q : queries ){
+            if( file.search(q) != binary_search(keys.data(), q, 0, SIZE-1) ){
+                std::cout << "Mismatch for key " << q << std::endl;
+                return 1;
+            }
+        }
+
+        double lookup_ns = time_per_query(queries, [&](int q){ return file.search(q); });
+
+        std::cout << std::endl << (load_sample ? "Sample in RAM:" : "Sample mapped:") << std::endl;
+        std::cout << "  opened " << file.getSize() << " keys in " << open_ns / 1000 << " us" << std::endl;
+        std::cout << "  " << lookup_ns << " ns/lookup" << std::endl;
+    }
+
+    std::filesystem::remove(filename);
+    return 0;
+}
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint64_t, std::int64_t
+#include <cstring>    //std::memcmp, std::memcpy
+#include <fstream>    //std::ofstream
+#include <stdexcept>  //std::runtime_error, std::invalid_argument
+#include <string>
+#include <vector>
+#include "binary_search.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>     //open
+#include <sys/mman.h>  //mmap, madvise
+#include <sys/stat.h>  //fstat
+#include <unistd.h>    //close
+#endif
+
+// On disk sorted key file
+// Notes:
+// - Layout, all integers in native byte order:
+//     [0, 4096)                header page: Key_File_Header, zero padded
+//     [sample_offset, ...)     sample: every sample_stride-th key, padded to a whole page
+//     [data_offset, ...)       the sorted int keys
+// - The stride is one page worth of keys, so the sample has one entry per data page. Searching the
+//   sample tells us which single data page can hold the answer.
+// - Sections start on page boundaries so a data page never straddles two OS pages.
+struct Key_File_Header {
+    char magic[8];
+    std::uint64_t count;
+    std::uint64_t sample_stride;
+    std::uint64_t sample_count;
+    std::uint64_t sample_offset;
+    std::uint64_t data_offset;
+};
+
+constexpr char KEY_FILE_MAGIC[8] = { 'H', 'T', 'C', 'K', 'E', 'Y', 'S', '1' };
+constexpr std::uint64_t KEY_FILE_PAGE = 4096;
+
+// Write a sorted key file
+// Notes:
+// - Throws std::invalid_argument if the keys are not sorted, std::runtime_error if the write fails.
+inline void write_sorted_key_file( const std::string& path, const int keys[], std::size_t count ){
+    for( std::size_t i = 1; i < count; ++i ){
+        if( keys[i] < keys[i-1] ){
+            throw std::invalid_argument("Keys must be sorted. Key " + std::to_string(i) + " is smaller than the one before it");
+        }
+    }
+
+    auto round_up = [](std::uint64_t bytes){ return (bytes + KEY_FILE_PAGE - 1) / KEY_FILE_PAGE * KEY_FILE_PAGE; };
+
+    Key_File_Header header{};
+    std::memcpy(header.magic, KEY_FILE_MAGIC, sizeof(header.magic));
+    header.count = count;
+    header.sample_stride = KEY_FILE_PAGE / sizeof(int);
+    header.sample_count = (count + header.sample_stride - 1) / header.sample_stride;
+    header.sample_offset = KEY_FILE_PAGE;
+    header.data_offset = header.sample_offset + round_up(header.sample_count * sizeof(int));
+
+    std::vector<int> sample(header.sample_count);
+    for( std::uint64_t s = 0; s < header.sample_count; ++s ){ sample[s] = keys[s * header.sample_stride]; }
+
+    std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if( !ofs.is_open() ){ throw std::runtime_error("Could not open " + path + " for writing"); }
+
+    std::vector<char> page(KEY_FILE_PAGE, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    ofs.write(page.data(), static_cast<std::streamsize>(page.size()));
+
+    ofs.write(reinterpret_cast<const char*>(sample.data()), static_cast<std::streamsize>(sample.size() * sizeof(int)));
+    std::vector<char> padding(header.data_offset - header.sample_offset - sample.size() * sizeof(int), 0);
+    ofs.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    ofs.write(reinterpret_cast<const char*>(keys), static_cast<std::streamsize>(count * sizeof(int)));
+
+    if( !ofs ){ throw std::runtime_error("Failed while writing " + path); }
+}
+
+// Read only view of a sorted key file, searched straight from the page cache
+// Notes:
+// - Opening only maps the file and reads the header page, so startup time doesn't depend on file size.
+//   Pages are faulted in by the lookups that need them.
+// - The data is tagged MADV_RANDOM: lookups jump around and kernel read ahead would only drag in
+//   pages we won't touch. The sample is tagged MADV_WILLNEED so the kernel starts pulling it in early.
+// - With load_sample = true the sample is also copied into RAM. Then a cold lookup searches the sample
+//   in memory and faults in exactly one data page. Copying costs one read of n/1024 keys.
+// - Without the in-RAM sample the sample is searched in place, which is still only a couple of page
+//   faults because the sample is 1024x smaller than the data.
+// - Positions are 64 bit since these files are allowed to hold more than 2^31 keys.
+class Mapped_Key_File {
+
+    using size_type = std::size_t;
+
+    private:
+        const char* mapping;
+        size_type mapping_bytes;
+        const int* keys;
+        const int* sample;
+        size_type count;
+        size_type stride;
+        size_type sample_count;
+        std::vector<int> sample_in_ram;
+
+#if defined(_WIN32)
+        HANDLE file;
+        HANDLE file_mapping;
+#endif
+
+        void unmap(){
+#if defined(_WIN32)
+            if( mapping != nullptr ){ UnmapViewOfFile(mapping); }
+            if( file_mapping != nullptr ){ CloseHandle(file_mapping); }
+            if( file != INVALID_HANDLE_VALUE ){ CloseHandle(file); }
+#else
+            if( mapping != nullptr ){ munmap(const_cast<char*>(mapping), mapping_bytes); }
+#endif
+            mapping = nullptr;
+#if defined(_WIN32)
+            file_mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#endif
+        }
+
+        void map( const std::string& path ){
+#if defined(_WIN32)
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+            if( file == INVALID_HANDLE_VALUE ){ throw std::runtime_error("Could not open " + path); }
+            LARGE_INTEGER file_size;
+            if( !GetFileSizeEx(file, &file_size) || static_cast<size_type>(file_size.QuadPart) < sizeof(Key_File_Header) ){
+                unmap();
+                throw std::runtime_error(path + " is too small to be a key file");
+            }
+            mapping_bytes = static_cast<size_type>(file_size.QuadPart);
+            file_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if( file_mapping != nullptr ){ mapping = static_cast<const char*>(MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0)); }
+            if( mapping == nullptr ){
+                unmap();
+                throw std::runtime_error("Could not map " + path);
+            }
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if( fd < 0 ){ throw std::runtime_error("Could not open " + path); }
+            struct stat st;
+            if( fstat(fd, &st) != 0 || static_cast<size_type>(st.st_size) < sizeof(Key_File_Header) ){
+                ::close(fd);
+                throw std::runtime_error(path + " is too small to be a key file");
+            }
+            mapping_bytes = static_cast<size_type>(st.st_size);
+            void* address = mmap(nullptr, mapping_bytes, PROT_READ, MAP_SHARED, fd, 0);
+            // the mapping keeps its own reference to the file
+            ::close(fd);
+            if( address == MAP_FAILED ){ throw std::runtime_error("Could not map " + path); }
+            mapping = static_cast<const char*>(address);
+#endif
+        }
+
+        // First position in the file holding a key >= val
+        size_type lower_bound_pos( int val ) const {
+            if( count == 0 ){ return 0; }
+
+            // sample[t] = keys[t*stride] >= val and sample[t-1] < val, so the answer is in ((t-1)*stride, t*stride]
+            const int* s = sample_in_ram.empty() ? sample : sample_in_ram.data();
+            size_type t = search::lower_bound(s, sample_count, val);
+            if( t == 0 ){ return 0; }
+
+            size_type first = (t - 1) * stride + 1;
+            size_type last = t * stride < count ? t * stride : count;
+            return first + search::lower_bound(keys + first, last - first, val);
+        }
+
+    public:
+        explicit Mapped_Key_File( const std::string& path, bool load_sample = false ):
+            mapping(nullptr),
+            mapping_bytes(0),
+            keys(nullptr),
+            sample(nullptr),
+            count(0),
+            stride(1),
+            sample_count(0)
+#if defined(_WIN32)
+            , file(INVALID_HANDLE_VALUE),
+            file_mapping(nullptr)
+#endif
+        {
+            map(path);
+
+            Key_File_Header header;
+            std::memcpy(&header, mapping, sizeof(header));
+            bool valid = std::memcmp(header.magic, KEY_FILE_MAGIC, sizeof(header.magic)) == 0
+                      && header.sample_stride > 0
+                      && header.sample_count == (header.count + header.sample_stride - 1) / header.sample_stride
+                      && header.sample_offset + header.sample_count * sizeof(int) <= header.data_offset
+                      && header.data_offset + header.count * sizeof(int) <= mapping_bytes;
+            if( !valid ){
+                unmap();
+                throw std::runtime_error(path + " is not a valid sorted key file");
+            }
+
+            count = static_cast<size_type>(header.count);
+            stride = static_cast<size_type>(header.sample_stride);
+            sample_count = static_cast<size_type>(header.sample_count);
+            keys = reinterpret_cast<const int*>(mapping + header.data_offset);
+            sample = reinterpret_cast<const int*>(mapping + header.sample_offset);
+
+#if !defined(_WIN32)
+            madvise(const_cast<char*>(mapping) + header.data_offset, mapping_bytes - header.data_offset, MADV_RANDOM);
+            madvise(const_cast<char*>(mapping) + header.sample_offset, header.data_offset - header.sample_offset, MADV_WILLNEED);
+#endif
+
+            if( load_sample ){ sample_in_ram.assign(sample, sample + sample_count); }
+        }
+
+        Mapped_Key_File( const Mapped_Key_File& ) = delete;
+        Mapped_Key_File& operator=( const Mapped_Key_File& ) = delete;
+
+        ~Mapped_Key_File(){ unmap(); }
+
+        size_type getSize() const { return count; }
+        const int* data() const { return keys; }
+
+        // Index of the first key >= val, or getSize() if there is none
+        size_type lower_bound( int val ) const { return lower_bound_pos(val); }
+
+        // Index of val in the file or -1, the binary_search contract with 64 bit positions
+        std::int64_t search( int val ) const {
+            size_type pos = lower_bound_pos(val);
+            if( pos < count && keys[pos] == val ){ return static_cast<std::int64_t>(pos); }
+            return -1;
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
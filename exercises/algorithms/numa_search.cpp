@@ -0,0 +1,88 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "numa_search.hpp"
+#include "thread_pool.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    // 64M ints is 256MB: 65536 normal pages, 128 huge ones
+    const int SIZE = 1 << 26;
+    const int QUERIES = 1 << 22;
+    std::vector<int> a(SIZE);
+    for( int i = 0; i < SIZE; ++i ){ a[i] = 2*i; }   // odd keys miss
+
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> dist(-1, 2*SIZE);
+    std::vector<int> queries(QUERIES);
+    for( auto& q : queries ){ q = dist(rng); }
+
+    std::cout << "NUMA nodes: " << search::numa_node_count() << ", this thread is on node " << search::current_numa_node() << std::endl;
+
+    auto describe = [](const char* name, const Numa_Replicated_Index& index){
+        std::cout << name << ": " << index.getReplicaCount() << " replica(s)";
+        for( std::size_t r = 0; r < index.getReplicaCount(); ++r ){
+            const search::Numa_Buffer& replica = index.getReplica(r);
+            std::cout << " [node " << r << ": " << replica.getBytes() / (1 << 20) << "MB on " << search::to_string(replica.getPageSize())
+                      << " pages" << (replica.isBound() ? ", bound" : "") << "]";
+        }
+        std::cout << std::endl;
+    };
+
+    Numa_Replicated_Index small_pages(a.data(), 0, SIZE-1, search::Page_Size::normal);
+    Numa_Replicated_Index huge_pages(a.data(), 0, SIZE-1, search::Page_Size::huge_1gb);
+    describe("4KB pages requested", small_pages);
+    describe("1GB pages requested", huge_pages);
+
+    // Sub ranges, empty ones and the ends must match binary_search exactly
+    for( auto range : { std::pair<int, int>{ 0, 0 }, { 5, 4 }, { 1000, 1999 }, { SIZE/2, SIZE-1 } } ){
+        Numa_Replicated_Index checked(a.data(), range.first, range.second, search::Page_Size::normal);
+        for( int q = 0; q < 100000; ++q ){
+            int val = q < 4000 ? 2*range.first - 2000 + q : queries[q];
+            int expected_bound = static_cast<int>(std::lower_bound(a.begin() + range.first, a.begin() + (range.second + 1 > range.first ? range.second + 1 : range.first), val) - a.begin());
+            if( checked.search(val) != binary_search(a.data(), val, range.first, range.second) || checked.lower_bound(val) != expected_bound ){
+                std::cout << "Mismatch for " << val << " in [" << range.first << ", " << range.second << "]" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Best of 3 runs, a shared box adds a lot of noise to DRAM bound loops
+    double vector_ns = best_of(3, [&]{ return time_per_query(queries, [&](int q){ return binary_search(a.data(), q, 0, SIZE-1); }); });
+    double small_ns = best_of(3, [&]{ return time_per_query(queries, [&](int q){ return small_pages.search(q); }); });
+    double huge_ns = best_of(3, [&]{ return time_per_query(queries, [&](int q){ return huge_pages.search(q); }); });
+
+    std::cout << std::endl << "One thread, " << QUERIES << " lookups:" << std::endl;
+    std::cout << "  binary_search on std::vector: " << vector_ns << " ns/lookup" << std::endl;
+    std::cout << "  4KB page replicas:            " << small_ns << " ns/lookup" << std::endl;
+    std::cout << "  huge page replicas:           " << huge_ns << " ns/lookup" << std::endl;
+
+    // Every thread searches through the same index object and ends up on its own node's copy
+    Thread_Pool pool;
+    const int CHUNK = 1 << 14;
+    std::atomic<int> next{ 0 };
+    std::atomic<int> mismatches{ 0 };
+    auto worker = [&](std::size_t){
+        int local_mismatches = 0;
+        for( int first = next.fetch_add(CHUNK); first < QUERIES; first = next.fetch_add(CHUNK) ){
+            for( int q = first; q < first + CHUNK && q < QUERIES; ++q ){
+                local_mismatches += huge_pages.search(queries[q]) != (queries[q] >= 0 && queries[q] % 2 == 0 && queries[q] < 2*SIZE ? queries[q] / 2 : -1);
+            }
+        }
+        mismatches += local_mismatches;
+    };
+    double seconds = time_ns([&]{ pool.run(worker); }) / 1e9;
+
+    std::cout << pool.getSize() << " threads: " << QUERIES / seconds / 1e6 << " M lookups/s" << std::endl;
+    if( mismatches != 0 ){
+        std::cout << mismatches << " threaded lookups disagree with binary_search" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
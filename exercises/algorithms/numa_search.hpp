@@ -0,0 +1,301 @@
+#pragma once
+
+#include <cstddef>    //std::size_t
+#include <cstring>    //std::memcpy
+#include <memory>     //std::unique_ptr, std::make_unique
+#include <new>        //std::bad_alloc
+#include <string>
+#include <vector>
+#include "binary_search.hpp"
+
+// Build flags
+// Notes:
+// - SEARCH_USE_LIBNUMA: on Linux, find nodes and place memory with libnuma (link with -lnuma).
+//   Without it we make the mbind and getcpu system calls ourselves and read the node list from
+//   sysfs, so nothing extra has to be installed.
+// - Windows uses its own NUMA API and large pages. Anything else gets a single replica on normal pages.
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <fstream>     //std::ifstream
+#include <sys/mman.h>  //mmap, munmap, madvise
+#include <sys/syscall.h> //SYS_mbind, SYS_getcpu
+#include <unistd.h>    //syscall
+#if defined(SEARCH_USE_LIBNUMA)
+#include <numa.h>
+#include <sched.h>     //sched_getcpu
+#endif
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+#endif
+
+namespace search {
+
+// Pages backing a block of memory
+// Notes:
+// - huge_2mb and huge_1gb come from the reserved huge page pool (hugetlbfs on Linux, large pages on
+//   Windows). Those have to be set up by the admin, so asking for them can fail.
+// - transparent_2mb is a normal mapping aligned to 2MB and flagged MADV_HUGEPAGE. The kernel backs it
+//   with 2MB pages when it can find them, no setup needed.
+enum class Page_Size { normal, transparent_2mb, huge_2mb, huge_1gb };
+
+inline const char* to_string( Page_Size pages ){
+    switch( pages ){
+        case Page_Size::transparent_2mb: return "transparent 2MB";
+        case Page_Size::huge_2mb:        return "2MB";
+        case Page_Size::huge_1gb:        return "1GB";
+        default:                         return "4KB";
+    }
+}
+
+// NUMA nodes of this machine, numbered 0 .. numa_node_count()-1. 1 when we can't tell.
+inline int numa_node_count(){
+#if defined(_WIN32)
+    ULONG highest = 0;
+    return GetNumaHighestNodeNumber(&highest) ? static_cast<int>(highest) + 1 : 1;
+#elif defined(__linux__) && defined(SEARCH_USE_LIBNUMA)
+    return numa_available() < 0 ? 1 : numa_max_node() + 1;
+#elif defined(__linux__)
+    // "0", "0-1" or "0,2-3". The last number is the highest node.
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if( !(online >> nodes) || nodes.empty() ){ return 1; }
+    std::size_t last = nodes.find_last_of(",-");
+    return std::stoi(last == std::string::npos ? nodes : nodes.substr(last + 1)) + 1;
+#else
+    return 1;
+#endif
+}
+
+// Node of the cpu the calling thread is running on right now
+inline int current_numa_node(){
+#if defined(_WIN32)
+    PROCESSOR_NUMBER processor;
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    return GetNumaProcessorNodeEx(&processor, &node) ? static_cast<int>(node) : 0;
+#elif defined(__linux__) && defined(SEARCH_USE_LIBNUMA)
+    int cpu = sched_getcpu();
+    int node = cpu < 0 || numa_available() < 0 ? 0 : numa_node_of_cpu(cpu);
+    return node < 0 ? 0 : node;
+#elif defined(__linux__)
+    unsigned cpu = 0, node = 0;
+    return syscall(SYS_getcpu, &cpu, &node, nullptr) == 0 ? static_cast<int>(node) : 0;
+#else
+    return 0;
+#endif
+}
+
+// Page aligned memory placed on one NUMA node
+// Notes:
+// - Tries the page size asked for and falls back one step at a time: 1GB, 2MB, transparent 2MB, normal.
+//   getPageSize() tells what we actually got.
+// - Placement is set before anything touches the memory, so every page is allocated on `node` when it
+//   is first written, whichever thread writes it. isBound() is false when the OS said no (one node,
+//   a container without the permission, ...). The memory still works, it just lands wherever the
+//   first write happens.
+class Numa_Buffer {
+
+    using size_type = std::size_t;
+
+    private:
+        void* memory;
+        size_type bytes;
+        Page_Size pages;
+        bool bound;
+
+        static size_type roundUp( size_type n, size_type unit ){ return (n + unit - 1) / unit * unit; }
+
+#if defined(__linux__)
+        void* mapHuge( size_type n, int flags ){
+            void* address = mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | flags, -1, 0);
+            return address == MAP_FAILED ? nullptr : address;
+        }
+
+        // Normal pages on a 2MB boundary, so transparent huge pages can back the whole range
+        void* mapAligned( size_type n ){
+            const size_type ALIGN = size_type(2) << 20;
+            void* address = mmap(nullptr, n + ALIGN, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( address == MAP_FAILED ){ return nullptr; }
+            char* start = static_cast<char*>(address);
+            char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<size_type>(start), ALIGN));
+            if( aligned != start ){ munmap(start, static_cast<size_type>(aligned - start)); }
+            munmap(aligned + n, static_cast<size_type>(start + n + ALIGN - (aligned + n)));
+            return aligned;
+        }
+
+        bool bind( int node ){
+#if defined(SEARCH_USE_LIBNUMA)
+            if( numa_available() < 0 ){ return false; }
+            numa_tonode_memory(memory, bytes, node);
+            return true;
+#else
+            const size_type BITS = 8 * sizeof(unsigned long);
+            std::vector<unsigned long> mask(static_cast<size_type>(node) / BITS + 1, 0);
+            mask[static_cast<size_type>(node) / BITS] = 1ul << (static_cast<size_type>(node) % BITS);
+            const int MPOL_BIND_MODE = 2;
+            // the kernel reads maxnode - 1 bits
+            return syscall(SYS_mbind, memory, bytes, MPOL_BIND_MODE, mask.data(), mask.size() * BITS + 1, 0) == 0;
+#endif
+        }
+#endif
+
+    public:
+        Numa_Buffer( size_type size, int node, Page_Size wanted ):
+            memory(nullptr),
+            bytes(size == 0 ? 1 : size),
+            pages(Page_Size::normal),
+            bound(false)
+        {
+#if defined(__linux__)
+            const size_type MB2 = size_type(2) << 20, GB1 = size_type(1) << 30;
+            if( wanted == Page_Size::huge_1gb && (memory = mapHuge(roundUp(bytes, GB1), MAP_HUGE_1GB)) != nullptr ){
+                bytes = roundUp(bytes, GB1);
+                pages = Page_Size::huge_1gb;
+            } else if( wanted >= Page_Size::huge_2mb && (memory = mapHuge(roundUp(bytes, MB2), MAP_HUGE_2MB)) != nullptr ){
+                bytes = roundUp(bytes, MB2);
+                pages = Page_Size::huge_2mb;
+            } else if( wanted != Page_Size::normal && (memory = mapAligned(roundUp(bytes, MB2))) != nullptr ){
+                bytes = roundUp(bytes, MB2);
+                pages = madvise(memory, bytes, MADV_HUGEPAGE) == 0 ? Page_Size::transparent_2mb : Page_Size::normal;
+            } else {
+                void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                memory = address == MAP_FAILED ? nullptr : address;
+            }
+            if( memory == nullptr ){ throw std::bad_alloc(); }
+            bound = numa_node_count() > 1 && bind(node);
+#elif defined(_WIN32)
+            // Large pages need the "Lock pages in memory" privilege, without it the call simply fails.
+            // Windows has no 1GB option on this path, so huge_1gb gets 2MB pages too.
+            HANDLE process = GetCurrentProcess();
+            ULONG win_node = static_cast<ULONG>(node);
+            SIZE_T large = GetLargePageMinimum();
+            if( wanted >= Page_Size::huge_2mb && large != 0 ){
+                memory = VirtualAllocExNuma(process, nullptr, roundUp(bytes, large), MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, win_node);
+                if( memory != nullptr ){
+                    bytes = roundUp(bytes, large);
+                    pages = Page_Size::huge_2mb;
+                }
+            }
+            if( memory == nullptr ){ memory = VirtualAllocExNuma(process, nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, win_node); }
+            if( memory == nullptr ){ throw std::bad_alloc(); }
+            bound = numa_node_count() > 1;
+#else
+            (void)node;
+            (void)wanted;
+            memory = ::operator new(bytes, std::align_val_t(4096));
+#endif
+        }
+
+        Numa_Buffer( const Numa_Buffer& ) = delete;
+        Numa_Buffer& operator=( const Numa_Buffer& ) = delete;
+
+        ~Numa_Buffer(){
+#if defined(__linux__)
+            munmap(memory, bytes);
+#elif defined(_WIN32)
+            VirtualFree(memory, 0, MEM_RELEASE);
+#else
+            ::operator delete(memory, std::align_val_t(4096));
+#endif
+        }
+
+        void* data() const { return memory; }
+        size_type getBytes() const { return bytes; }
+        Page_Size getPageSize() const { return pages; }
+        bool isBound() const { return bound; }
+};
+
+} // namespace search
+
+// Read only sorted int table copied once per NUMA node, on huge pages
+// Notes:
+// - On a multi socket box a thread searching memory on the other socket pays the interconnect on every
+//   probe that misses cache, and a binary search misses on most of them. With one copy per node every
+//   thread reads local memory only, for the price of one copy of the table per node.
+// - A 16MB table on 4KB pages is 4096 TLB entries, far more than the TLB holds, so most deep probes
+//   also pay a page walk. On 2MB pages it is 8 entries, on 1GB pages one.
+// - Neither gain shows on a single node box. There the 256MB table in numa_search.cpp on transparent
+//   2MB pages measured 556-760 ns per lookup against 514-555 ns for binary_search on a plain vector
+//   (10-35% slower), and 4KB page replicas 732-815 ns. Measure on the real machine.
+// - search() works out the calling thread's node and uses that replica. The node is cached per thread
+//   and looked up again every 1024 lookups, so a thread the scheduler moves finds its new home soon.
+// - Answers follow the binary_search contract on the original inclusive range [begin, end], so this is
+//   a drop-in replacement for binary_search(a, val, begin, end).
+class Numa_Replicated_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        std::vector<std::unique_ptr<search::Numa_Buffer>> replicas;   // one per node, or just one
+        size_type size;
+        int offset;
+
+        static int localNode(){
+            thread_local int node = 0;
+            thread_local unsigned calls = 0;
+            if( (calls++ & 1023) == 0 ){ node = search::current_numa_node(); }
+            return node;
+        }
+
+        const int* local() const {
+            size_type node = static_cast<size_type>(localNode());
+            return static_cast<const int*>(replicas[node < replicas.size() ? node : 0]->data());
+        }
+
+    public:
+        // Copy the inclusive range [begin, end] of a sorted array onto every node
+        // Notes:
+        // - pages is what we ask for, see search::Numa_Buffer for the fallbacks.
+        // - replicate = false keeps a single copy on node 0, handy to measure what the replicas buy.
+        // - Throws std::bad_alloc if even normal pages can't be had.
+        Numa_Replicated_Index( const int sorted[], int begin, int end, search::Page_Size pages = search::Page_Size::huge_2mb, bool replicate = true ):
+            size(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0),
+            offset(begin)
+        {
+            int nodes = replicate ? search::numa_node_count() : 1;
+            for( int node = 0; node < nodes; ++node ){
+                // one spare slot after the keys for search()
+                replicas.push_back(std::make_unique<search::Numa_Buffer>((size + 1) * sizeof(int), node, pages));
+                int* keys = static_cast<int*>(replicas.back()->data());
+                if( size > 0 ){ std::memcpy(keys, sorted + begin, size * sizeof(int)); }
+                keys[size] = 0;
+            }
+        }
+
+        size_type getSize() const { return size; }
+        size_type getReplicaCount() const { return replicas.size(); }
+        const search::Numa_Buffer& getReplica( size_type i ) const { return *replicas.at(i); }
+
+        // The copy this thread searches
+        const int* data() const { return local(); }
+
+        // Index of the first element >= val in the original array, or end+1 if there is none
+        int lower_bound( int val ) const {
+            return offset + static_cast<int>(search::lower_bound(local(), size, val));
+        }
+
+        // Index of val in the original array or -1, matching binary_search
+        // Notes:
+        // - The answer is picked with search::select (binary_search.hpp), hit or miss never branches.
+        // - Every replica has a spare slot past the end, so keys[i] can be read even when i == size and
+        //   the "past the end" test folds into the select too.
+        int search( int val ) const {
+            const int* keys = local();
+            size_type i = search::lower_bound(keys, size, val);
+            bool hit = (i != size) & (keys[i] == val);
+            return search::select(hit, offset + static_cast<int>(i), -1);
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <algorithm>
+#include <execution>
+#include <memory>     //std::unique_ptr
+#include <numeric>    //std::iota
+#include <random>     //std::mt19937
+#include <thread>
+#include <vector>
+#include "binary_search.hpp"
+#include "parallel_binary_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    // 64M ints is 256MB, far bigger than any cache
+    const int SIZE = 1 << 26;
+    const int QUERIES = 1 << 24;
+    std::vector<int> a(SIZE);
+    std::iota(a.begin(), a.end(), 0);
+    for( auto& e : a ){ e *= 2; }   // odd keys miss
+
+    std::mt19937 rng;
+    rng.seed(1234);
+    std::uniform_int_distribution<int> dist(-10, 2 * SIZE + 10);
+    std::vector<int> queries(QUERIES);
+    for( auto& q : queries ){ q = dist(rng); }
+
+    std::cout << "Searching with up to " << std::thread::hardware_concurrency() << " threads" << std::endl;
+
+    // The reference answer: plain binary_search one query at a time
+    std::vector<int> expected(QUERIES);
+    double loop_ns = time_ns([&]{
+        for( int q = 0; q < QUERIES; ++q ){ expected[q] = binary_search(a.data(), queries[q], 0, SIZE-1); }
+    });
+    std::cout << "  binary_search loop: " << loop_ns / QUERIES << " ns/lookup" << std::endl;
+
+    // Results go into a buffer nobody has written to yet, so its pages land next to the worker that fills them
+    auto time_policy = [&](const char* name, auto&& policy){
+        std::unique_ptr<int[]> results(new int[QUERIES]);
+        std::span<int> out(results.get(), QUERIES);
+
+        double elapsed = time_ns([&]{ binary_search_batch(policy, a.data(), 0, SIZE-1, queries, out); });
+
+        bool same = std::equal(out.begin(), out.end(), expected.begin());
+        long long sum = 0;
+        for( auto r : out ){ sum += r; }
+        sink = sum;
+        std::cout << "  " << name << elapsed / QUERIES << " ns/lookup, "
+                  << QUERIES / (elapsed / 1e9) / 1e6 << " M lookups/s" << (same ? "" : "  MISMATCH") << std::endl;
+        return same;
+    };
+
+    bool ok = time_policy("batch, seq:          ", std::execution::seq);
+    ok = time_policy("batch, par:          ", std::execution::par) && ok;
+    ok = time_policy("batch, par_unseq:    ", std::execution::par_unseq) && ok;
+
+    // The templated form hands back positions instead of indices or -1
+    std::vector<std::size_t> bounds(QUERIES);
+    search::lower_bound_batch(std::execution::par, std::span<const int>(a), std::span<const int>(queries), std::span<std::size_t>(bounds));
+    for( int q = 0; q < QUERIES && ok; ++q ){
+        auto reference = static_cast<std::size_t>(std::lower_bound(a.begin(), a.end(), queries[q]) - a.begin());
+        ok = bounds[q] == reference;
+    }
+
+    // Odd sized batches leave a partial last slice
+    for( int count : { 0, 1, 16383, 16385, 100000 } ){
+        std::vector<int> out(count);
+        binary_search_batch(std::execution::par, a.data(), 0, SIZE-1, std::span<const int>(queries.data(), count), out);
+        ok = ok && std::equal(out.begin(), out.end(), expected.begin());
+    }
+
+    std::cout << (ok ? "All policies agree with binary_search" : "Mismatch!") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>  //std::for_each
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uintptr_t
+#include <execution>  //std::execution::seq, par, par_unseq
+#include <functional> //std::less
+#include <span>
+#include <type_traits> //std::is_execution_policy_v
+#include <vector>
+#include "binary_search.hpp"
+
+namespace search {
+
+// Queries handed to one task of a parallel batch
+// Notes:
+// - 16K queries is 64KB of int results (128KB of size_t), a whole number of 4KB pages. The slices are
+//   cut on page boundaries of the results buffer (see page_slices below), so no two tasks ever write
+//   into the same page of output: there is no false sharing at the edges and every page is first
+//   touched by exactly one thread (see binary_search_batch below).
+// - It is also big enough that a task runs for hundreds of microseconds, which hides the cost of
+//   handing it to a worker.
+inline constexpr std::size_t PARALLEL_SLICE = 1 << 14;
+inline constexpr std::size_t PARALLEL_PAGE = 4096;
+
+// One task's share of a batch: queries [first, first + size)
+struct Slice {
+    std::size_t first;
+    std::size_t size;
+};
+
+// Cuts a batch of results.size() queries into slices that start on page boundaries of results
+// Notes:
+// - A buffer from new or std::vector is only 16 byte aligned, so it rarely starts on a page. The first
+//   slice runs up to the first page boundary and every later one covers PARALLEL_SLICE results from
+//   there, only the first and last slice are short.
+// - If the elements don't divide a page evenly no boundary lines up with an element, we then cut
+//   plain PARALLEL_SLICE slices from the start and the edge pages may be shared.
+// - The standard parallel algorithms want forward iterators, so we hand them a small vector of slices
+//   rather than a view.
+template<class R>
+std::vector<Slice> page_slices( std::span<R> results ){
+    std::size_t count = results.size();
+    std::size_t to_page = (PARALLEL_PAGE - reinterpret_cast<std::uintptr_t>(results.data()) % PARALLEL_PAGE) % PARALLEL_PAGE;
+    std::size_t boundary = to_page % sizeof(R) == 0 && PARALLEL_PAGE % sizeof(R) == 0 ? to_page / sizeof(R) : 0;
+    if( boundary > count ){ boundary = count; }
+
+    std::vector<Slice> slices;
+    slices.reserve((count - boundary + PARALLEL_SLICE - 1) / PARALLEL_SLICE + 1);
+    if( boundary > 0 ){ slices.push_back({0, boundary}); }
+    for( std::size_t first = boundary; first < count; first += PARALLEL_SLICE ){
+        slices.push_back({first, count - first < PARALLEL_SLICE ? count - first : PARALLEL_SLICE});
+    }
+    return slices;
+}
+
+// lower_bound_batch spread over cores with a standard execution policy
+// Notes:
+// - results[i] receives lower_bound(data, queries[i]), same as the single threaded lower_bound_batch.
+// - Each slice of PARALLEL_SLICE queries is one task and runs the lockstep batch on its own, so every
+//   core keeps Group misses in flight. seq runs the slices one after another on the calling thread.
+template<class ExecutionPolicy, std::size_t Group = 16, class T, class Compare = std::less<>>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void lower_bound_batch( ExecutionPolicy&& policy, std::span<const T> data, std::span<const T> queries, std::span<std::size_t> results, Compare comp = Compare{} ){
+    std::vector<Slice> slices = page_slices(results.first(queries.size()));
+    std::for_each(std::forward<ExecutionPolicy>(policy), slices.begin(), slices.end(), [&](const Slice& slice){
+        search::lower_bound_batch<Group>(data, queries.subspan(slice.first, slice.size), results.subspan(slice.first, slice.size), comp);
+    });
+}
+
+} // namespace search
+
+// Batched binary_search over the inclusive range [begin, end], spread over cores
+// Notes:
+// - Pass std::execution::seq, par or par_unseq. results[i] is exactly what
+//   binary_search(search_array, queries[i], begin, end) would return, whatever the policy.
+// - Every worker only ever writes its own slice of results. Memory pages go to the NUMA node of the
+//   thread that first writes them, so if the results buffer hasn't been touched yet (new int[n], or
+//   a buffer that was only reserved) each slice of output ends up local to the core that filled it.
+//   Zero filling it on the calling thread first (std::vector<int>(n)) puts every page on that node.
+// - The table itself is shared and read by everyone. Once every core is busy a lookup is about 20
+//   cache misses, so throughput stops scaling when the memory bandwidth runs out, not the cores.
+// - The parallel policies need a backend: MSVC has one built in, libstdc++ uses TBB (link with -ltbb).
+//   Without one they quietly run sequentially.
+template<class ExecutionPolicy>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+void binary_search_batch( ExecutionPolicy&& policy, const int search_array[], int begin, int end, std::span<const int> queries, std::span<int> results ){
+    std::vector<search::Slice> slices = search::page_slices(results.first(queries.size()));
+    std::for_each(std::forward<ExecutionPolicy>(policy), slices.begin(), slices.end(), [&](const search::Slice& slice){
+        binary_search_batch(search_array, begin, end, queries.subspan(slice.first, slice.size), results.subspan(slice.first, slice.size));
+    });
+}
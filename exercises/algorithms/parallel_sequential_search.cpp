@@ -0,0 +1,51 @@
+#include <iostream>
+#include <random>     //std::mt19937
+#include <thread>
+#include <vector>
+#include "parallel_sequential_search.hpp"
+#include "sequential_search.hpp"
+#include "thread_pool.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    // A big unsorted array, 64M ints is 256MB
+    const int SIZE = 1 << 26;
+    std::vector<int> a(SIZE);
+
+    std::mt19937 rng;
+    rng.seed(1234);
+    std::uniform_int_distribution<int> dist(0, 1 << 30);
+    for( auto& e : a ){ e = dist(rng); }
+
+    Thread_Pool pool;
+    std::cout << "Searching with " << pool.getSize() << " threads" << std::endl;
+
+    // Plant the same key twice. The search must report the lower index no matter which worker sees
+    // its copy first.
+    const int KEY = -42;
+    int positions[] = { 17, SIZE/3, SIZE/2 + 12345, SIZE-1 };
+    for( auto first : positions ){
+        a[first] = KEY;
+        if( first + 1000 < SIZE ){ a[first + 1000] = KEY; }
+
+        int parallel = -1;
+        double parallel_ns = time_ns([&]{ parallel = parallel_sequential_search(pool, a.data(), KEY, 0, SIZE-1); });
+        int serial = -1;
+        double serial_ns = time_ns([&]{ serial = sequential_search(a.data(), KEY, 0, SIZE-1); });
+
+        std::cout << "Key @ a[" << first << "]: parallel found " << parallel << " in " << parallel_ns / 1e6
+                  << " ms, serial found " << serial << " in " << serial_ns / 1e6 << " ms" << std::endl;
+        if( parallel != serial ){ return 1; }
+
+        a[first] = 0;
+        if( first + 1000 < SIZE ){ a[first + 1000] = 0; }
+    }
+
+    // A miss has to read every element, so this is the bandwidth bound case
+    int missing = 0;
+    double miss_ns = time_ns([&]{ missing = parallel_sequential_search(pool, a.data(), KEY, 0, SIZE-1); });
+    std::cout << "Miss: " << missing << " scanned at " << (SIZE * sizeof(int)) / miss_ns << " GB/s" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <climits>    //LLONG_MAX
+#include <cstddef>    //std::size_t
+#include "sequential_search.hpp"
+#include "thread_pool.hpp"
+
+// Multithreaded sequential_search over the inclusive range [begin, end]
+// Notes:
+// - Returns the lowest index holding val, or -1, exactly like sequential_search.
+// - The range is cut into chunks that workers claim in increasing order from an atomic counter.
+//   Each chunk is scanned with the vectorized sequential_search kernel.
+// - Workers share an atomic "best index so far". A hit lowers it with a compare exchange loop, and
+//   everyone checks it before claiming a chunk and between the blocks of a chunk. Any chunk that starts
+//   past the best hit can't hold a lower one, so a hit near the front stops the whole pool quickly.
+// - Chunks are claimed in order, so every chunk in front of the best hit is always scanned to
+//   completion. That is what makes the answer the lowest index and not just any index.
+// - Small ranges aren't worth waking the pool for and run on the calling thread.
+inline int parallel_sequential_search( Thread_Pool& pool, const int search_array[], int val, int begin, int end ){
+    const long long CHUNK = 1 << 16;   // elements claimed at a time, 256KB of ints
+    const long long BLOCK = 1 << 12;   // elements scanned between checks of the best index
+
+    if( end < begin ){ return -1; }
+    long long n = static_cast<long long>(end) - begin + 1;
+    if( pool.getSize() == 1 || n <= 4 * CHUNK ){ return sequential_search(search_array, val, begin, end); }
+
+    std::atomic<long long> next_chunk{ 0 };
+    std::atomic<long long> best{ LLONG_MAX };
+    const long long chunks = (n + CHUNK - 1) / CHUNK;
+
+    auto lower_best = [&best](long long found){
+        long long current = best.load(std::memory_order_relaxed);
+        while( found < current && !best.compare_exchange_weak(current, found, std::memory_order_relaxed) ){ }
+    };
+
+    pool.run([&](std::size_t){
+        while( true ){
+            long long c = next_chunk.fetch_add(1, std::memory_order_relaxed);
+            if( c >= chunks ){ return; }
+
+            long long chunk_begin = begin + c * CHUNK;
+            long long chunk_end = chunk_begin + CHUNK - 1 < end ? chunk_begin + CHUNK - 1 : end;
+            if( chunk_begin > best.load(std::memory_order_relaxed) ){ return; }
+
+            for( long long b = chunk_begin; b <= chunk_end; b += BLOCK ){
+                if( b > best.load(std::memory_order_relaxed) ){ return; }
+                long long block_end = b + BLOCK - 1 < chunk_end ? b + BLOCK - 1 : chunk_end;
+                int found = sequential_search(search_array, val, static_cast<int>(b), static_cast<int>(block_end));
+                if( found != -1 ){
+                    lower_best(found);
+                    break;
+                }
+            }
+        }
+    });
+
+    long long result = best.load();
+    return result == LLONG_MAX ? -1 : static_cast<int>(result);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint64_t
+
+// Probe instrumentation for the search routines
+// Notes:
+// - The searches take a Probes policy as their first template parameter and report to it after
+//   every comparison and at the end of every lookup. The policy only has static functions, so no
+//   state is passed around and the search signatures stay the same.
+// - No_Probes is the default. Its hooks are empty constexpr functions, the depth counter feeding them
+//   is dead code, and the optimizer removes all of it. The generated code is the same as before.
+// - Counting_Probes writes into a thread_local Probe_Stats, so threads never share a cache line and
+//   there are no atomics. Read a thread's numbers from that thread with search::probe_stats().
+// - Switch it on for one call site: search::lower_bound<search::Counting_Probes>(data, n, key)
+namespace search {
+
+struct No_Probes {
+    // one comparison at `depth` (0 is the first probe). went_right means the key is past the probe.
+    static constexpr void probe( std::size_t, bool ){}
+    // the lookup finished after `probes` comparisons
+    static constexpr void lookup( std::size_t ){}
+};
+
+// What Counting_Probes has seen on this thread
+// Notes:
+// - depth_histogram[d] counts lookups that took d comparisons. Lookups deeper than MAX_DEPTH - 1
+//   land in the last bucket, which can't happen for arrays that fit in memory.
+// - right_at_depth[d] / probes_at_depth[d] is how often the search went right at level d. Anything
+//   far from 0.5 on the top levels means the queries are skewed and a branchy search would predict well.
+struct Probe_Stats {
+    static constexpr std::size_t MAX_DEPTH = 64;
+
+    std::uint64_t lookups = 0;
+    std::uint64_t probes = 0;
+    std::uint64_t left = 0;
+    std::uint64_t right = 0;
+    std::array<std::uint64_t, MAX_DEPTH> depth_histogram{};
+    std::array<std::uint64_t, MAX_DEPTH> probes_at_depth{};
+    std::array<std::uint64_t, MAX_DEPTH> right_at_depth{};
+
+    double probes_per_lookup() const { return lookups == 0 ? 0.0 : static_cast<double>(probes) / static_cast<double>(lookups); }
+
+    void reset(){ *this = Probe_Stats{}; }
+};
+
+// This thread's stats block
+inline Probe_Stats& probe_stats(){
+    thread_local Probe_Stats stats;
+    return stats;
+}
+
+struct Counting_Probes {
+    static void probe( std::size_t depth, bool went_right ){
+        Probe_Stats& stats = search::probe_stats();
+        std::size_t d = depth < Probe_Stats::MAX_DEPTH ? depth : Probe_Stats::MAX_DEPTH - 1;
+        ++stats.probes;
+        ++stats.probes_at_depth[d];
+        stats.right_at_depth[d] += went_right;
+        stats.right += went_right;
+        stats.left += !went_right;
+    }
+
+    static void lookup( std::size_t probes ){
+        Probe_Stats& stats = search::probe_stats();
+        ++stats.lookups;
+        ++stats.depth_histogram[probes < Probe_Stats::MAX_DEPTH ? probes : Probe_Stats::MAX_DEPTH - 1];
+    }
+};
+
+} // namespace search
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "s_tree_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Same ordered array binary_search.cpp builds
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = i;
+    }
+
+    S_Tree_Index index(a, 0, SIZE-1);
+
+    auto found = index.search(a[SIZE/4]);
+    std::cout << "Searching for: " << a[SIZE/4] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
+    std::cout << "binary_search agrees: " << std::boolalpha << (found == binary_search(a, a[SIZE/4], 0, SIZE-1)) << std::endl;
+
+    // Check positions against binary_search on awkward sizes (partial leaves, partial internal nodes)
+    // Notes:
+    // - Keys are even so odd queries are misses. Duplicates are thrown in to check we return the first one.
+    std::mt19937 rng;
+    rng.seed(123456789);
+    for( int n : { 1, 2, 15, 16, 17, 271, 272, 273, 4624, 4625, 100000 } ){
+        std::vector<int> data(n);
+        for( auto i = 0; i < n; ++i ){ data[i] = 2*(i - i % 3); }
+        S_Tree_Index tree(data.data(), 0, n-1);
+        for( int val = -3; val <= 2*n + 3; ++val ){
+            if( tree.search(val) != binary_search(data.data(), val, 0, n-1) ){
+                std::cout << "Mismatch for n = " << n << " key " << val << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Random lookups on tables from L2 sized up to well past LLC
+    const int QUERIES = 1 << 20;
+    std::cout << std::endl << "     elements  height  binary ns  s-tree ns" << std::endl;
+    for( int big_size = 1 << 18; big_size <= 1 << 26; big_size <<= 2 ){
+        std::vector<int> big(big_size);
+        for( auto i = 0; i < big_size; ++i ){ big[i] = 2*i; }
+        S_Tree_Index tree(big.data(), 0, big_size-1);
+
+        std::uniform_int_distribution<int> dist(0, 2*big_size-1);
+        std::vector<int> queries(QUERIES);
+        std::generate(queries.begin(), queries.end(), [&]{ return dist(rng); });
+
+        auto binary_ns = time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, big_size-1); });
+        auto s_tree_ns = time_per_query(queries, [&](int q){ return tree.search(q); });
+
+        std::cout << "  " << big_size << "  " << tree.getHeight() << "  " << binary_ns << "  " << s_tree_ns << std::endl;
+    }
+
+    return 0;
+}
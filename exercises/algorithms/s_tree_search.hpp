@@ -0,0 +1,156 @@
+#pragma once
+
+#include <bit>        //std::popcount
+#include <climits>    //INT_MAX
+#include <cstddef>    //std::size_t
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "sequential_search.hpp"
+
+// Static B+ tree (S+ tree) over a read-only sorted int array
+// Notes:
+// - Every node is 16 ints, exactly one 64 byte cache line, so visiting a node costs one miss.
+// - The bottom layer holds the sorted keys themselves, padded with INT_MAX to a whole number of nodes.
+//   Each layer above it has 17 way nodes: key i is the largest key found under child i, and child 16
+//   needs no key. The rightmost subtree on every layer reports INT_MAX as its largest key, so a query
+//   larger than everything always walks down the right edge instead of falling off the tree.
+// - Searching a node means counting its keys that are smaller than the query. The keys are sorted, so
+//   that count is the child to visit next. One SIMD compare plus popcount does it without branches.
+// - Layers are stored root first in one cache line aligned buffer. The whole tree is built bottom up
+//   in a single linear pass over the input.
+// - A lookup touches about log17(n) nodes instead of the log2(n) cache lines of binary_search.
+class S_Tree_Index {
+
+    using size_type = std::size_t;
+
+    static constexpr size_type B = 16;
+
+    private:
+        std::vector<int, Aligned_Allocator<int>> nodes;
+        std::vector<size_type> layer_offset;   // layer_offset[0] is the leaf layer
+        size_type size;
+        int offset;
+        search::Simd_Level level;
+
+        static int rank_scalar( const int* keys, int val ){
+            int c = 0;
+            for( size_type i = 0; i < B; ++i ){ c += keys[i] < val; }
+            return c;
+        }
+
+#if defined(SEARCH_X86_SIMD)
+        SEARCH_TARGET("avx2")
+        static int rank_avx2( const int* keys, int val ){
+            const __m256i x = _mm256_set1_epi32(val);
+            __m256i lo = _mm256_cmpgt_epi32(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(keys)));
+            __m256i hi = _mm256_cmpgt_epi32(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + 8)));
+            unsigned int m = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(lo)))
+                           | static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(hi))) << 8;
+            return std::popcount(m);
+        }
+
+        SEARCH_TARGET("avx512f")
+        static int rank_avx512( const int* keys, int val ){
+            __mmask16 m = _mm512_cmplt_epi32_mask(_mm512_load_si512(keys), _mm512_set1_epi32(val));
+            return std::popcount(static_cast<unsigned int>(m));
+        }
+#endif
+
+        // Walk from the root to a leaf. rank is the node search used on every layer.
+        template<class Rank>
+        size_type descend( int val, Rank rank ) const {
+            size_type node = 0;
+            for( size_type l = layer_offset.size() - 1; l > 0; --l ){
+                node = node * (B + 1) + rank(nodes.data() + layer_offset[l] + node * B, val);
+            }
+
+            size_type pos = node * B + rank(nodes.data() + layer_offset[0] + node * B, val);
+            return pos < size ? pos : size;
+        }
+
+#if defined(SEARCH_X86_SIMD)
+        SEARCH_TARGET("avx2")
+        size_type descend_avx2( int val ) const { return descend(val, rank_avx2); }
+
+        SEARCH_TARGET("avx512f")
+        size_type descend_avx512( int val ) const { return descend(val, rank_avx512); }
+#endif
+
+        // First position in the sorted input (relative to begin) holding a key >= val
+        size_type lower_bound_pos( int val ) const {
+            if( size == 0 ){ return 0; }
+            switch( level ){
+#if defined(SEARCH_X86_SIMD)
+                case search::Simd_Level::avx512: return descend_avx512(val);
+                case search::Simd_Level::avx2:   return descend_avx2(val);
+#endif
+                default:                         return descend(val, rank_scalar);
+            }
+        }
+
+    public:
+        // Build from the inclusive range [begin, end] of a sorted array, same convention as binary_search
+        S_Tree_Index( const int sorted[], int begin, int end ):
+            size(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0),
+            offset(begin),
+            level(search::simd_level())
+        {
+            if( size == 0 ){ return; }
+
+            // Count the nodes in every layer so we can lay them out root first
+            std::vector<size_type> layer_nodes{ (size + B - 1) / B };
+            while( layer_nodes.back() > 1 ){
+                layer_nodes.push_back((layer_nodes.back() + B) / (B + 1));
+            }
+
+            layer_offset.resize(layer_nodes.size());
+            size_type total = 0;
+            for( size_type l = layer_nodes.size(); l-- > 0; ){
+                layer_offset[l] = total;
+                total += layer_nodes[l] * B;
+            }
+            nodes.assign(total, INT_MAX);
+
+            // Leaves are the input itself. The padding is already INT_MAX.
+            int* leaves = nodes.data() + layer_offset[0];
+            for( size_type i = 0; i < size; ++i ){ leaves[i] = sorted[begin + i]; }
+
+            // Largest key under each node of the layer below, with the right edge forced to INT_MAX
+            std::vector<int> child_max(layer_nodes[0]);
+            for( size_type j = 0; j < layer_nodes[0]; ++j ){ child_max[j] = leaves[j * B + B - 1]; }
+            child_max.back() = INT_MAX;
+
+            for( size_type l = 1; l < layer_nodes.size(); ++l ){
+                int* layer = nodes.data() + layer_offset[l];
+                std::vector<int> node_max(layer_nodes[l]);
+                for( size_type j = 0; j < layer_nodes[l]; ++j ){
+                    size_type first_child = j * (B + 1);
+                    for( size_type i = 0; i < B && first_child + i < layer_nodes[l-1]; ++i ){
+                        layer[j * B + i] = child_max[first_child + i];
+                    }
+                    size_type last_child = first_child + B < layer_nodes[l-1] ? first_child + B : layer_nodes[l-1] - 1;
+                    node_max[j] = child_max[last_child];
+                }
+                child_max.swap(node_max);
+            }
+        }
+
+        size_type getSize() const { return size; }
+
+        // Number of cache lines a lookup touches
+        size_type getHeight() const { return layer_offset.size(); }
+
+        // Index of the first element >= val in the original array, or end+1 if there is none
+        int lower_bound( int val ) const {
+            return offset + static_cast<int>(lower_bound_pos(val));
+        }
+
+        // Index of val in the original array or -1, matching binary_search
+        int search( int val ) const {
+            size_type pos = lower_bound_pos(val);
+            if( pos < size && nodes[layer_offset[0] + pos] == val ){ return offset + static_cast<int>(pos); }
+            return -1;
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
@@ -0,0 +1,297 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>    //INT_MIN
+#include <cmath>      //std::pow
+#include <cstdint>    //std::uint64_t
+#include <filesystem> //std::filesystem::create_directory
+#include <fstream>    //std::ofstream, std::ifstream
+#include <functional> //std::function
+#include <iomanip>    //std::setw
+#include <memory>     //std::make_unique
+#include <random>     //std::mt19937_64
+#include <string>
+#include <thread>     //std::thread::hardware_concurrency
+#include <vector>
+#include "../numeric-methods/understanding-numeric-error/src/json.hpp"
+#include "binary_search.hpp"
+#include "eytzinger_search.hpp"
+#include "exponential_search.hpp"
+#include "interpolation_search.hpp"
+#include "learned_index.hpp"
+#include "s_tree_search.hpp"
+#include "sequential_search.hpp"
+#include "veb_search.hpp"
+#include "benchmark_timer.hpp"
+
+// Search benchmark
+// Notes:
+// - Sweeps the table size from 1KB up to --max-bytes (4GB by default) in powers of 4 so we see every
+//   level of the memory hierarchy: L1, L2, L3 and DRAM.
+// - The table holds the even keys INT_MIN, INT_MIN+2, ... so any odd key is a guaranteed miss.
+// - Three query streams per size:
+//     uniform  - every key in the table is equally likely
+//     zipfian  - a few hot keys get most of the lookups (theta 0.99), scattered over the table
+//     all_miss - odd keys spread over the table, every lookup fails
+// - Every routine answers with the binary_search contract, so we sum the answers into a checksum and
+//   require all routines to agree before we report their timings.
+// - Index layouts (Eytzinger, van Emde Boas, S-tree, learned) are built per size. Eytzinger needs ~2x
+//   the table in extra memory and van Emde Boas pads up to 2x on these power of 4 sizes. Use
+//   --max-bytes to stay inside the RAM of the box.
+// - The layouts side by side: binary_search walks the plain sorted array, eytzinger prefetches for a
+//   64 byte line, s_tree is blocked for one, and van_emde_boas is blocked for every size at once.
+// - Results go to data/search_benchmark.json. Pass --baseline with an older file to flag anything
+//   that got more than 10% slower.
+//
+// Usage: search_benchmark [--max-bytes N] [--queries N] [--out file] [--baseline file]
+
+using json = nlohmann::json;
+
+// Zipf distributed ranks in [0, n) using the method from Gray et al, "Quickly Generating
+// Billion-Record Synthetic Databases". zeta(n) is summed exactly up to a million terms and the tail
+// is approximated by its integral so setup stays fast for billion element tables.
+class Zipf_Generator {
+    private:
+        double theta, alpha, zetan, eta;
+        std::uint64_t n;
+        std::uniform_real_distribution<double> unit;
+
+        static double zeta( std::uint64_t n, double theta ){
+            const std::uint64_t EXACT = 1000000;
+            double sum = 0;
+            std::uint64_t m = n < EXACT ? n : EXACT;
+            for( std::uint64_t i = 1; i <= m; ++i ){ sum += 1.0 / std::pow(static_cast<double>(i), theta); }
+            if( n > m ){
+                sum += (std::pow(static_cast<double>(n), 1 - theta) - std::pow(static_cast<double>(m), 1 - theta)) / (1 - theta);
+            }
+            return sum;
+        }
+
+    public:
+        Zipf_Generator( std::uint64_t n, double theta ):
+            theta(theta),
+            alpha(1.0 / (1.0 - theta)),
+            zetan(zeta(n, theta)),
+            n(n),
+            unit(0.0, 1.0)
+        {
+            eta = (1 - std::pow(2.0 / static_cast<double>(n), 1 - theta)) / (1 - zeta(2, theta) / zetan);
+        }
+
+        template<class Rng>
+        std::uint64_t operator()( Rng& rng ){
+            double u = unit(rng);
+            double uz = u * zetan;
+            if( uz < 1.0 ){ return 0; }
+            if( uz < 1.0 + std::pow(0.5, theta) ){ return n > 1 ? 1 : 0; }
+            auto rank = static_cast<std::uint64_t>(static_cast<double>(n) * std::pow(eta * u - eta + 1, alpha));
+            return rank < n ? rank : n - 1;
+        }
+};
+
+struct Routine {
+    std::string name;
+    std::size_t max_elements;   // skip the routine on bigger tables
+    std::function<long long(const std::vector<int>&)> run;
+};
+
+int main( int argc, char** argv ){
+
+    std::uint64_t max_bytes = 4ull << 30;
+    int query_count = 1 << 20;
+    std::string out_path = "data/search_benchmark.json";
+    std::string baseline_path;
+
+    for( int i = 1; i + 1 < argc; i += 2 ){
+        std::string flag = argv[i];
+        if( flag == "--max-bytes" ){ max_bytes = std::stoull(argv[i+1]); }
+        else if( flag == "--queries" ){ query_count = std::stoi(argv[i+1]); }
+        else if( flag == "--out" ){ out_path = argv[i+1]; }
+        else if( flag == "--baseline" ){ baseline_path = argv[i+1]; }
+        else {
+            std::cout << "Unknown flag " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    // Spacing the keys by 2 across the int range caps a table at 2^30 elements
+    if( max_bytes > (1ull << 30) * sizeof(int) ){ max_bytes = (1ull << 30) * sizeof(int); }
+
+    json report;
+    report["machine"]["simd"] = search::to_string(search::simd_level());
+    report["machine"]["threads"] = std::thread::hardware_concurrency();
+    report["queries"] = query_count;
+    report["results"] = json::array();
+
+    std::mt19937_64 rng;
+    rng.seed(123456789);
+
+    std::cout << std::left << std::setw(16) << "bytes" << std::setw(12) << "queries"
+              << std::setw(22) << "routine" << std::setw(12) << "ns/lookup" << "lookups/s" << std::endl;
+
+    for( std::uint64_t bytes = 1024; bytes <= max_bytes; bytes *= 4 ){
+        const int n = static_cast<int>(bytes / sizeof(int));
+
+        std::vector<int> table(n);
+        for( int i = 0; i < n; ++i ){ table[i] = INT_MIN + 2*i; }
+
+        // Index layouts over this table. Built once and shared by the three query streams.
+        auto eytzinger = std::make_unique<Eytzinger_Index>(table.data(), 0, n-1);
+        auto veb       = std::make_unique<Van_Emde_Boas_Index>(table.data(), 0, n-1);
+        auto s_tree    = std::make_unique<S_Tree_Index>(table.data(), 0, n-1);
+        auto learned   = std::make_unique<Learned_Index>(table.data(), 0, n-1, 64);
+
+        // Sequential search is O(n) per lookup, so only run it while the table is small
+        std::vector<Routine> routines = {
+            { "binary_search", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += binary_search(table.data(), q, 0, n-1); }
+                return sum;
+            } },
+            { "binary_search_batch", SIZE_MAX, [&](const std::vector<int>& qs){
+                std::vector<int> results(qs.size());
+                binary_search_batch(table.data(), 0, n-1, qs, results);
+                long long sum = 0;
+                for( auto r : results ){ sum += r; }
+                return sum;
+            } },
+            { "sequential_search", 1 << 16, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += sequential_search(table.data(), q, 0, n-1); }
+                return sum;
+            } },
+            { "eytzinger", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += eytzinger->search(q); }
+                return sum;
+            } },
+            { "van_emde_boas", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += veb->search(q); }
+                return sum;
+            } },
+            { "s_tree", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += s_tree->search(q); }
+                return sum;
+            } },
+            { "interpolation", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += interpolation_search(table.data(), q, 0, n-1); }
+                return sum;
+            } },
+            { "exponential", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += exponential_search(table.data(), q, 0, n-1); }
+                return sum;
+            } },
+            { "learned_index", SIZE_MAX, [&](const std::vector<int>& qs){
+                long long sum = 0;
+                for( auto q : qs ){ sum += learned->search(q); }
+                return sum;
+            } },
+        };
+
+        // Build the three query streams
+        std::vector<int> uniform(query_count), zipfian(query_count), all_miss(query_count);
+        std::uniform_int_distribution<int> any_index(0, n-1);
+        Zipf_Generator zipf(static_cast<std::uint64_t>(n), 0.99);
+        for( int q = 0; q < query_count; ++q ){
+            uniform[q] = table[any_index(rng)];
+            // scatter the hot ranks over the table so they aren't all in the first cache lines
+            std::uint64_t rank = zipf(rng);
+            zipfian[q] = table[static_cast<std::size_t>((rank * 2654435761ull) % static_cast<std::uint64_t>(n))];
+            all_miss[q] = table[any_index(rng)] + 1;
+        }
+
+        struct Stream { const char* name; const std::vector<int>* queries; };
+        Stream streams[] = { { "uniform", &uniform }, { "zipfian", &zipfian }, { "all_miss", &all_miss } };
+
+        for( auto& stream : streams ){
+            long long expected = 0;
+            bool have_expected = false;
+
+            for( auto& routine : routines ){
+                if( static_cast<std::size_t>(n) > routine.max_elements ){ continue; }
+
+                long long checksum = 0;
+                double elapsed = time_ns([&]{ checksum = routine.run(*stream.queries); });
+                sink = checksum;
+
+                if( !have_expected ){ expected = checksum; have_expected = true; }
+                if( checksum != expected ){
+                    std::cout << routine.name << " disagrees with binary_search on " << stream.name
+                              << " queries at " << bytes << " bytes" << std::endl;
+                    return 1;
+                }
+
+                double ns = elapsed / query_count;
+                double per_second = 1e9 / ns;
+
+                report["results"].push_back({
+                    { "routine", routine.name },
+                    { "distribution", stream.name },
+                    { "bytes", bytes },
+                    { "elements", n },
+                    { "ns_per_lookup", ns },
+                    { "lookups_per_second", per_second },
+                    { "checksum", checksum }
+                });
+
+                std::cout << std::left << std::setw(16) << bytes << std::setw(12) << stream.name
+                          << std::setw(22) << routine.name << std::setw(12) << ns << per_second << std::endl;
+            }
+        }
+    }
+
+    // Note: use a try catch block since IO operations can fail easily
+    try{
+        auto parent = std::filesystem::path(out_path).parent_path();
+        if( !parent.empty() ){ std::filesystem::create_directories(parent); }
+        std::ofstream ofs(out_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+        if( !ofs.is_open() ){
+            std::cout << "Could not open " << out_path << " for writing" << std::endl;
+            return 1;
+        }
+        ofs << std::setw(2) << report << std::endl;
+        ofs.close();
+        if( !ofs ){
+            std::cout << "Failed writing " << out_path << std::endl;
+            return 1;
+        }
+    } catch(std::exception &e) {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << std::endl << "Wrote " << out_path << std::endl;
+
+    // Compare against an older run. Same routine, distribution and size must not be >10% slower.
+    if( !baseline_path.empty() ){
+        json baseline;
+        try{
+            std::ifstream ifs(baseline_path);
+            baseline = json::parse(ifs);
+        } catch(std::exception &e) {
+            std::cout << e.what() << std::endl;
+            return 1;
+        }
+
+        int regressions = 0;
+        for( auto& old : baseline["results"] ){
+            for( auto& now : report["results"] ){
+                if( now["routine"] != old["routine"] || now["distribution"] != old["distribution"] || now["bytes"] != old["bytes"] ){ continue; }
+                double before = old["ns_per_lookup"];
+                double after = now["ns_per_lookup"];
+                if( after > before * 1.10 ){
+                    std::cout << "Regression: " << now["routine"].get<std::string>() << " " << now["distribution"].get<std::string>()
+                              << " @ " << now["bytes"] << " bytes: " << before << " -> " << after << " ns" << std::endl;
+                    ++regressions;
+                }
+            }
+        }
+        std::cout << regressions << " regression(s) against " << baseline_path << std::endl;
+        if( regressions > 0 ){ return 2; }
+    }
+
+    return 0;
+}
@@ -1,30 +1,92 @@
-#include <iostream>
-#include <numeric>
-#include <array>
-
-int sequential_search( int search_array[], int val, int begin, int end ){
-    int i = 0;
-    for ( i = begin; i <=end; ++i){
-        if( val == search_array[i]){ return i; }
-    }
-    
-    return -1;
-}
-
-int main(){
-
-    const auto SIZE = 100;
-    int a[SIZE];
-
-    srand(1234);
-    for( auto e : a) {
-        e = rand();
-    }
-
-    auto found = sequential_search(a, a[SIZE/2], 0, SIZE);
-
-    std::cout << "Searching for: " << a[SIZE/2] << std::endl;
-    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
-
-    return 0;
-}
\ No newline at end of file
+#include <iostream>
+#include <numeric>
+#include <array>
+#include <ranges>     //std::views::iota
+#include <cstdlib>    //srand, rand
+#include <vector>
+#include "sequential_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 100;
+    int a[SIZE];
+
+    // Notes:
+    // - iterate by reference! `for( auto e : a )` copies each element and leaves `a` uninitialized
+    srand(1234);
+    for( auto& e : a) {
+        e = rand();
+    }
+
+    std::cout << "Dispatching to: " << search::to_string(search::simd_level()) << std::endl;
+
+    auto found = sequential_search(a, a[SIZE/2], 0, SIZE-1);
+
+    std::cout << "Searching for: " << a[SIZE/2] << std::endl;
+    std::cout << "Found: " << a[found] << " @ a[" << found << "]" << std::endl;
+
+    // Plant a few duplicates and count them
+    a[7] = a[SIZE/2];
+    a[SIZE-1] = a[SIZE/2];
+    auto counted = sequential_search_count(a, a[SIZE/2], 0, SIZE-1);
+    std::cout << "First: " << counted.first << " Count: " << counted.count << std::endl;
+
+    // Check every kernel this cpu supports against the scalar path
+    // Notes:
+    // - We slide the key and the range bounds around so every tail length gets exercised.
+    std::vector<int> data(1000);
+    for( auto& e : data ){ e = rand() % 64; }
+    for( int level = 0; level <= static_cast<int>(search::simd_level()); ++level ){
+        auto kernel = search::pick_search_kernel(static_cast<search::Simd_Level>(level));
+        auto count_kernel = search::pick_count_kernel(static_cast<search::Simd_Level>(level));
+        for( int begin = 0; begin < 70; ++begin ){
+            for( int end = begin; end < static_cast<int>(data.size()); end += 37 ){
+                for( int val = 0; val < 70; val += 7 ){
+                    auto expected = search::sequential_count_scalar(data.data(), val, begin, end);
+                    auto counted_here = count_kernel(data.data(), val, begin, end);
+                    if( kernel(data.data(), val, begin, end) != expected.first
+                        || counted_here.first != expected.first || counted_here.count != expected.count ){
+                        std::cout << "Mismatch in " << search::to_string(static_cast<search::Simd_Level>(level)) << std::endl;
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    // The sentinel scan writes into the buffer, so check it on a copy and make sure it puts things back
+    std::vector<int> writable = data;
+    for( int begin = 0; begin < 70; ++begin ){
+        for( int end = begin; end < static_cast<int>(writable.size()); end += 37 ){
+            for( int val = 0; val < 70; val += 7 ){
+                if( search::sequential_search_sentinel(writable.data(), val, begin, end) != search::sequential_search_scalar(data.data(), val, begin, end)
+                    || writable != data ){
+                    std::cout << "Mismatch in sentinel search" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // Time repeated scans of a small unsorted array that fits in L1
+    // Notes:
+    // - The keys are never present so every scan walks the whole array.
+    const int SMALL_SIZE = 1024;
+    const int SCANS = 200000;
+    std::vector<int> small(SMALL_SIZE);
+    for( auto& e : small ){ e = rand() % 1000000; }
+
+    std::cout << std::endl << "Scanning " << SMALL_SIZE << " ints:" << std::endl;
+    for( int level = 0; level <= static_cast<int>(search::simd_level()); ++level ){
+        auto kernel = search::pick_search_kernel(static_cast<search::Simd_Level>(level));
+        double ns = time_per_query(std::views::iota(0, SCANS), [&](int s){ return kernel(small.data(), -1 - s, 0, SMALL_SIZE-1); });
+        std::cout << "  " << search::to_string(static_cast<search::Simd_Level>(level)) << ": " << ns << " ns/scan" << std::endl;
+    }
+
+    // The sentinel loop is for targets without the vector kernels, so compare it against the plain scalar loop
+    double sentinel_ns = time_per_query(std::views::iota(0, SCANS), [&](int s){ return search::sequential_search_sentinel(small.data(), -1 - s, 0, SMALL_SIZE-1); });
+    std::cout << "  scalar sentinel: " << sentinel_ns << " ns/scan" << std::endl;
+
+    return 0;
+}
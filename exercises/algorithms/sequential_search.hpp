@@ -0,0 +1,336 @@
+#pragma once
+
+#include <bit>        //std::countr_zero, std::popcount
+#include <cstdint>    //std::uint32_t
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define SEARCH_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>   //__cpuidex
+#else
+#include <cpuid.h>    //__cpuid_count
+#endif
+#endif
+
+// Let GCC and Clang compile a single function for a wider instruction set than the rest of the file.
+// MSVC lets us use any intrinsic anywhere so the macro is empty there.
+#if defined(SEARCH_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define SEARCH_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SEARCH_TARGET(isa)
+#endif
+
+namespace search {
+
+// Result of a scan that also counts hits
+// Notes:
+// - first is -1 when the key was not found, same as sequential_search
+struct Scan_Result {
+    int first;
+    int count;
+};
+
+// The instruction sets we know how to scan with, from slowest to fastest
+enum class Simd_Level { scalar, sse2, avx2, avx512 };
+
+inline const char* to_string( Simd_Level level ){
+    switch( level ){
+        case Simd_Level::sse2:   return "sse2";
+        case Simd_Level::avx2:   return "avx2";
+        case Simd_Level::avx512: return "avx512";
+        default:                 return "scalar";
+    }
+}
+
+// Plain one element at a time scan over the inclusive range [begin, end]
+inline int sequential_search_scalar( const int search_array[], int val, int begin, int end ){
+    for( int i = begin; i <= end; ++i ){
+        if( val == search_array[i] ){ return i; }
+    }
+
+    return -1;
+}
+
+inline Scan_Result sequential_count_scalar( const int search_array[], int val, int begin, int end ){
+    Scan_Result result{ -1, 0 };
+    for( int i = begin; i <= end; ++i ){
+        if( val == search_array[i] ){
+            if( result.first == -1 ){ result.first = i; }
+            ++result.count;
+        }
+    }
+
+    return result;
+}
+
+// Sentinel scan over the inclusive range [begin, end] of a writable buffer
+// Notes:
+// - The plain loop asks two questions per element: are we still in range, and is this the key.
+//   We drop the first one by planting val in the last slot of the range so the scan has to stop there.
+//   The last element is saved first and put back before we return.
+// - Unrolled by 8 with one compare per element. Each check exits on the first hit, so we never read
+//   past the sentinel even though the group of 8 straddles the end.
+// - We use the last slot of the range rather than one past it, so the caller doesn't need spare
+//   capacity. Landing on the sentinel means a miss unless the saved value was val.
+// - The buffer is modified while we scan. Don't share it with another thread during the search.
+inline int sequential_search_sentinel( int search_array[], int val, int begin, int end ){
+    if( end < begin ){ return -1; }
+
+    const int last = search_array[end];
+    search_array[end] = val;
+
+    const int* p = search_array;
+    int i = begin;
+    for( ;; i += 8 ){
+        if( p[i]     == val ){ break; }
+        if( p[i + 1] == val ){ i += 1; break; }
+        if( p[i + 2] == val ){ i += 2; break; }
+        if( p[i + 3] == val ){ i += 3; break; }
+        if( p[i + 4] == val ){ i += 4; break; }
+        if( p[i + 5] == val ){ i += 5; break; }
+        if( p[i + 6] == val ){ i += 6; break; }
+        if( p[i + 7] == val ){ i += 7; break; }
+    }
+
+    search_array[end] = last;
+    if( i < end || last == val ){ return i; }
+    return -1;
+}
+
+#if defined(SEARCH_X86_SIMD)
+
+// Ask the cpu and the OS which vector extensions we may use
+// Notes:
+// - cpuid tells us what the cpu implements. xgetbv tells us whether the OS saves the wider
+//   registers on a context switch. We need both before touching ymm/zmm registers.
+// - leaf 1 ecx: bit 26 xsave, bit 27 osxsave, bit 28 avx. leaf 7 ebx: bit 5 avx2, bit 16 avx512f.
+inline Simd_Level detect_simd_level(){
+    unsigned int regs[4] = { 0, 0, 0, 0 };
+    auto cpuid = [&regs](unsigned int leaf){
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, static_cast<int>(leaf), 0);
+        for( int i = 0; i < 4; ++i ){ regs[i] = static_cast<unsigned int>(r[i]); }
+#else
+        __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    };
+    auto xgetbv = []() -> std::uint64_t {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        std::uint32_t lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (static_cast<std::uint64_t>(hi) << 32) | lo;
+#endif
+    };
+
+    // sse2 is part of the x86-64 baseline
+    Simd_Level level = Simd_Level::sse2;
+
+    cpuid(0);
+    unsigned int max_leaf = regs[0];
+    cpuid(1);
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx     = (regs[2] >> 28) & 1;
+    if( !osxsave || !avx || max_leaf < 7 ){ return level; }
+
+    std::uint64_t xcr0 = xgetbv();
+    bool ymm_state = (xcr0 & 0x06) == 0x06;
+    bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+
+    cpuid(7);
+    bool avx2    = (regs[1] >> 5) & 1;
+    bool avx512f = (regs[1] >> 16) & 1;
+
+    if( avx2 && ymm_state ){ level = Simd_Level::avx2; }
+    if( avx512f && zmm_state ){ level = Simd_Level::avx512; }
+    return level;
+}
+
+// Vector kernels
+// Notes:
+// - Each iteration compares 4 registers worth of keys and ORs the masks so the hot loop only has one
+//   branch. When that branch fires we look at the registers one by one and use count trailing zeros
+//   on the movemask to find the exact lane.
+// - Whatever doesn't fill a whole iteration is handled by the scalar loop.
+SEARCH_TARGET("sse2")
+inline int sequential_search_sse2( const int search_array[], int val, int begin, int end ){
+    const __m128i key = _mm_set1_epi32(val);
+    int i = begin;
+    for( ; i + 16 <= end + 1; i += 16 ){
+        const __m128i* p = reinterpret_cast<const __m128i*>(search_array + i);
+        __m128i c0 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 0), key);
+        __m128i c1 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), key);
+        __m128i c2 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 2), key);
+        __m128i c3 = _mm_cmpeq_epi32(_mm_loadu_si128(p + 3), key);
+        __m128i any = _mm_or_si128(_mm_or_si128(c0, c1), _mm_or_si128(c2, c3));
+        if( _mm_movemask_epi8(any) != 0 ){
+            unsigned int m = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c0)))
+                           | static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c1))) << 4
+                           | static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c2))) << 8
+                           | static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c3))) << 12;
+            return i + std::countr_zero(m);
+        }
+    }
+
+    return sequential_search_scalar(search_array, val, i, end);
+}
+
+SEARCH_TARGET("avx2")
+inline int sequential_search_avx2( const int search_array[], int val, int begin, int end ){
+    const __m256i key = _mm256_set1_epi32(val);
+    int i = begin;
+    for( ; i + 32 <= end + 1; i += 32 ){
+        const __m256i* p = reinterpret_cast<const __m256i*>(search_array + i);
+        __m256i c0 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 0), key);
+        __m256i c1 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), key);
+        __m256i c2 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 2), key);
+        __m256i c3 = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 3), key);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1), _mm256_or_si256(c2, c3));
+        if( !_mm256_testz_si256(any, any) ){
+            unsigned int m = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c0)))
+                           | static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c1))) << 8
+                           | static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c2))) << 16
+                           | static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c3))) << 24;
+            return i + std::countr_zero(m);
+        }
+    }
+
+    return sequential_search_scalar(search_array, val, i, end);
+}
+
+SEARCH_TARGET("avx512f")
+inline int sequential_search_avx512( const int search_array[], int val, int begin, int end ){
+    const __m512i key = _mm512_set1_epi32(val);
+    int i = begin;
+    for( ; i + 64 <= end + 1; i += 64 ){
+        const int* p = search_array + i;
+        std::uint64_t m = static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p +  0), key))
+                        | static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p + 16), key)) << 16
+                        | static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p + 32), key)) << 32
+                        | static_cast<std::uint64_t>(_mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p + 48), key)) << 48;
+        if( m != 0 ){ return i + std::countr_zero(m); }
+    }
+
+    // the tail is at most 63 elements, finish it with masked 16 lane compares
+    for( ; i <= end; i += 16 ){
+        int remaining = end + 1 - i;
+        __mmask16 lanes = remaining >= 16 ? __mmask16(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+        __m512i v = _mm512_maskz_loadu_epi32(lanes, search_array + i);
+        unsigned int m = _mm512_mask_cmpeq_epi32_mask(lanes, v, key);
+        if( m != 0 ){ return i + std::countr_zero(m); }
+    }
+
+    return -1;
+}
+
+// Counting kernels
+// Notes:
+// - These must look at every element, so there is no early exit. popcount of the movemask gives the
+//   number of hits per register and the first non zero mask pins down the first index.
+SEARCH_TARGET("sse2")
+inline Scan_Result sequential_count_sse2( const int search_array[], int val, int begin, int end ){
+    const __m128i key = _mm_set1_epi32(val);
+    Scan_Result result{ -1, 0 };
+    int i = begin;
+    for( ; i + 4 <= end + 1; i += 4 ){
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(search_array + i)), key);
+        unsigned int m = static_cast<unsigned int>(_mm_movemask_ps(_mm_castsi128_ps(c)));
+        if( result.first == -1 && m != 0 ){ result.first = i + std::countr_zero(m); }
+        result.count += std::popcount(m);
+    }
+
+    Scan_Result tail = sequential_count_scalar(search_array, val, i, end);
+    if( result.first == -1 ){ result.first = tail.first; }
+    result.count += tail.count;
+    return result;
+}
+
+SEARCH_TARGET("avx2")
+inline Scan_Result sequential_count_avx2( const int search_array[], int val, int begin, int end ){
+    const __m256i key = _mm256_set1_epi32(val);
+    Scan_Result result{ -1, 0 };
+    int i = begin;
+    for( ; i + 8 <= end + 1; i += 8 ){
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(search_array + i)), key);
+        unsigned int m = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(c)));
+        if( result.first == -1 && m != 0 ){ result.first = i + std::countr_zero(m); }
+        result.count += std::popcount(m);
+    }
+
+    Scan_Result tail = sequential_count_scalar(search_array, val, i, end);
+    if( result.first == -1 ){ result.first = tail.first; }
+    result.count += tail.count;
+    return result;
+}
+
+SEARCH_TARGET("avx512f")
+inline Scan_Result sequential_count_avx512( const int search_array[], int val, int begin, int end ){
+    const __m512i key = _mm512_set1_epi32(val);
+    Scan_Result result{ -1, 0 };
+    for( int i = begin; i <= end; i += 16 ){
+        int remaining = end + 1 - i;
+        __mmask16 lanes = remaining >= 16 ? __mmask16(0xFFFF) : static_cast<__mmask16>((1u << remaining) - 1);
+        __m512i v = _mm512_maskz_loadu_epi32(lanes, search_array + i);
+        unsigned int m = _mm512_mask_cmpeq_epi32_mask(lanes, v, key);
+        if( result.first == -1 && m != 0 ){ result.first = i + std::countr_zero(m); }
+        result.count += std::popcount(m);
+    }
+
+    return result;
+}
+
+#else
+
+inline Simd_Level detect_simd_level(){ return Simd_Level::scalar; }
+
+#endif
+
+// The level picked for this process. cpuid only runs once, the first time anyone asks.
+inline Simd_Level simd_level(){
+    static const Simd_Level level = detect_simd_level();
+    return level;
+}
+
+using Search_Kernel = int (*)( const int[], int, int, int );
+using Count_Kernel  = Scan_Result (*)( const int[], int, int, int );
+
+inline Search_Kernel pick_search_kernel( Simd_Level level ){
+    switch( level ){
+#if defined(SEARCH_X86_SIMD)
+        case Simd_Level::avx512: return sequential_search_avx512;
+        case Simd_Level::avx2:   return sequential_search_avx2;
+        case Simd_Level::sse2:   return sequential_search_sse2;
+#endif
+        default:                 return sequential_search_scalar;
+    }
+}
+
+inline Count_Kernel pick_count_kernel( Simd_Level level ){
+    switch( level ){
+#if defined(SEARCH_X86_SIMD)
+        case Simd_Level::avx512: return sequential_count_avx512;
+        case Simd_Level::avx2:   return sequential_count_avx2;
+        case Simd_Level::sse2:   return sequential_count_sse2;
+#endif
+        default:                 return sequential_count_scalar;
+    }
+}
+
+} // namespace search
+
+// Find the first index of val in the inclusive range [begin, end] or -1
+// Notes:
+// - Runs the widest kernel this cpu supports. The choice is made once and cached in a function pointer.
+inline int sequential_search( const int search_array[], int val, int begin, int end ){
+    static const search::Search_Kernel kernel = search::pick_search_kernel(search::simd_level());
+    return kernel(search_array, val, begin, end);
+}
+
+// Same as sequential_search but scans the whole range and also reports how many times val occurs
+inline search::Scan_Result sequential_search_count( const int search_array[], int val, int begin, int end ){
+    static const search::Count_Kernel kernel = search::pick_count_kernel(search::simd_level());
+    return kernel(search_array, val, begin, end);
+}
@@ -0,0 +1,108 @@
+#include <iostream>
+#include <algorithm>
+#include <iterator>   //std::back_inserter
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "sorted_set_operations.hpp"
+#include "benchmark_timer.hpp"
+
+// Sorted list of `count` distinct random ids below `limit`
+std::vector<int> make_ids( std::mt19937& rng, int count, int limit ){
+    std::uniform_int_distribution<int> dist(0, limit-1);
+    std::vector<int> ids(count);
+    std::generate(ids.begin(), ids.end(), [&]{ return dist(rng); });
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+int main(){
+
+    std::vector<int> a = { 1, 3, 4, 7, 9, 10, 12, 15, 20 };
+    std::vector<int> b = { 2, 3, 7, 8, 10, 15, 16, 21, 22, 23 };
+    std::vector<int> out(a.size() + b.size());
+
+    auto print = [&](const char* name, std::size_t count){
+        std::cout << name;
+        for( std::size_t i = 0; i < count; ++i ){ std::cout << out[i] << (i + 1 < count ? ", " : ""); }
+        std::cout << std::endl;
+    };
+    print("a & b: ", search::intersect_sorted(a, b, out));
+    print("a | b: ", search::union_sorted(a, b, out));
+    print("a - b: ", search::difference_sorted(a, b, out));
+
+    // Check every path against the standard library for a spread of sizes and ratios
+    std::mt19937 rng;
+    rng.seed(123456789);
+    for( int trial = 0; trial < 2000; ++trial ){
+        int na = trial % 97;
+        int nb = (trial * 7) % 4000;
+        auto x = make_ids(rng, na, 200 + trial);
+        auto y = make_ids(rng, nb, 200 + trial);
+        std::vector<int> expected, got(x.size() + y.size());
+
+        std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+        got.resize(search::intersect_sorted(x, y, got));
+        bool ok = got == expected;
+
+        expected.clear(); got.resize(x.size() + y.size());
+        std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+        got.resize(search::union_sorted(x, y, got));
+        ok = ok && got == expected;
+
+        for( int flip = 0; flip < 2; ++flip ){
+            auto& l = flip ? y : x;
+            auto& r = flip ? x : y;
+            expected.clear(); got.assign(l.size(), 0);
+            std::set_difference(l.begin(), l.end(), r.begin(), r.end(), std::back_inserter(expected));
+            got.resize(search::difference_sorted(l, r, got));
+            ok = ok && got == expected;
+            got.assign(l.size(), 0);
+            got.resize(search::difference_block(l.data(), l.size(), r.data(), r.size(), got.data()));
+            ok = ok && got == expected;
+        }
+
+        expected.clear(); got.assign(x.size() + y.size(), 0);
+        std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+        got.resize(search::intersect_block(x.data(), x.size(), y.data(), y.size(), got.data()));
+        ok = ok && got == expected;
+
+        if( !ok ){
+            std::cout << "Mismatch on trial " << trial << std::endl;
+            return 1;
+        }
+    }
+
+    // Time intersections of similar and very unequal sizes
+    // Notes:
+    // - "per element" uses binary_search for every element of the short list, which is what we did before.
+    // - Galloping is timed on its own too, past BATCH_RATIO intersect_sorted no longer uses it.
+    struct Case { int small_size; int large_size; };
+    Case cases[] = { { 1 << 20, 1 << 20 }, { 1 << 16, 1 << 22 }, { 1 << 12, 1 << 22 } };
+    for( auto& test : cases ){
+        auto small = make_ids(rng, test.small_size, 1 << 24);
+        auto large = make_ids(rng, test.large_size, 1 << 24);
+        std::vector<int> result(small.size());
+
+        std::size_t per_element = 0;
+        double binary_ns = time_ns([&]{
+            for( auto v : small ){
+                if( binary_search(large.data(), v, 0, static_cast<int>(large.size())-1) != -1 ){ result[per_element++] = v; }
+            }
+        });
+
+        std::size_t galloped = 0;
+        double gallop_ns = time_ns([&]{ galloped = search::intersect_gallop(small.data(), small.size(), large.data(), large.size(), result.data()); });
+
+        std::size_t common = 0;
+        double kernel_ns = time_ns([&]{ common = search::intersect_sorted(small, large, result); });
+
+        std::cout << std::endl << small.size() << " x " << large.size() << " ids:" << std::endl;
+        std::cout << "  binary_search per element: " << per_element << " common in " << binary_ns / 1e6 << " ms" << std::endl;
+        std::cout << "  intersect_gallop:          " << galloped << " common in " << gallop_ns / 1e6 << " ms" << std::endl;
+        std::cout << "  intersect_sorted:          " << common << " common in " << kernel_ns / 1e6 << " ms" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>    //std::size_t
+#include <functional> //std::function
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that all run the same job together
+// Notes:
+// - run(job) calls job(i) once on every worker and once on the calling thread (i = 0), then waits
+//   for all of them. Work splitting is up to the job, usually by pulling chunks off an atomic counter.
+// - Threads are started once and parked on a condition variable between jobs, so a run() costs a
+//   wake up and not a thread creation.
+// - Only one run() at a time. The pool is meant to be owned by whoever drives the search.
+class Thread_Pool {
+
+    using size_type = std::size_t;
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void(size_type)>* job;
+        size_type generation;
+        size_type pending;
+        bool stopping;
+
+        void work( size_type index ){
+            size_type seen = 0;
+            while( true ){
+                const std::function<void(size_type)>* current = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&]{ return stopping || generation != seen; });
+                    if( stopping ){ return; }
+                    seen = generation;
+                    current = job;
+                }
+
+                (*current)(index);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if( --pending == 0 ){ done.notify_one(); }
+            }
+        }
+
+    public:
+        // threads counts the calling thread, so Thread_Pool(1) runs everything inline
+        explicit Thread_Pool( size_type threads = std::thread::hardware_concurrency() ):
+            job(nullptr),
+            generation(0),
+            pending(0),
+            stopping(false)
+        {
+            if( threads == 0 ){ threads = 1; }
+            for( size_type i = 1; i < threads; ++i ){
+                workers.emplace_back([this, i]{ work(i); });
+            }
+        }
+
+        Thread_Pool( const Thread_Pool& ) = delete;
+        Thread_Pool& operator=( const Thread_Pool& ) = delete;
+
+        ~Thread_Pool(){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for( auto& t : workers ){ t.join(); }
+        }
+
+        size_type getSize() const { return workers.size() + 1; }
+
+        void run( const std::function<void(size_type)>& task ){
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &task;
+                pending = workers.size();
+                ++generation;
+            }
+            wake.notify_all();
+
+            task(0);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&]{ return pending == 0; });
+        }
+};
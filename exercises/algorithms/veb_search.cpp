@@ -0,0 +1,85 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>    //INT_MIN, INT_MAX
+#include <random>     //std::mt19937
+#include <vector>
+#include "binary_search.hpp"
+#include "eytzinger_search.hpp"
+#include "veb_search.hpp"
+#include "benchmark_timer.hpp"
+
+int main(){
+
+    const auto SIZE = 10;
+    int a[SIZE];
+
+    // Initalized ordered array with even values so odd keys are misses
+    for( auto i = 0; i < SIZE; ++i) {
+        a[i] = 2*i;
+    }
+
+    Van_Emde_Boas_Index index(a, 0, SIZE-1);
+
+    std::cout << "Searching keys 0 through " << 2*SIZE << " in a tree of height " << index.getHeight() << std::endl;
+    for( auto val = 0; val <= 2*SIZE; ++val ){
+        std::cout << val << " -> van Emde Boas: " << index.search(val)
+                  << " binary: " << binary_search(a, val, 0, SIZE-1) << std::endl;
+    }
+
+    // Every size up to a few thousand, with duplicates and the extreme keys, on sub ranges
+    // Notes:
+    // - Sizes that aren't 2^h - 1 get padding, and INT_MAX in the data has to win over the padding.
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> small_values(-40, 40);
+    for( int n = 0; n <= 3000; n += (n < 70 ? 1 : 97) ){
+        std::vector<int> data(n + 2);
+        for( auto& e : data ){ e = small_values(rng); }
+        if( n > 4 ){ data[1] = INT_MIN; data[n] = INT_MAX; data[n-1] = INT_MAX; }
+        std::sort(data.begin() + 1, data.begin() + 1 + n);
+
+        Van_Emde_Boas_Index checked(data.data(), 1, n);
+        std::vector<int> keys = { INT_MIN, INT_MIN + 1, INT_MAX - 1, INT_MAX };
+        for( int v = -42; v <= 42; ++v ){ keys.push_back(v); }
+        for( auto val : keys ){
+            int expected_bound = static_cast<int>(std::lower_bound(data.begin() + 1, data.begin() + 1 + n, val) - data.begin());
+            if( checked.search(val) != binary_search(data.data(), val, 1, n) || checked.lower_bound(val) != expected_bound ){
+                std::cout << "Mismatch for " << val << " with " << n << " elements" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Compare the three layouts with random lookups on tables from L2 sized up to well past LLC
+    // Notes:
+    // - Half the queries are misses so we also exercise the "not found" path.
+    // - Every rank is checked against binary_search before we trust the timings.
+    const int QUERIES = 1 << 20;
+
+    std::cout << std::endl << "     elements  binary ns  eytzinger ns  van Emde Boas ns" << std::endl;
+    for( int big_size = 1 << 18; big_size <= 1 << 26; big_size <<= 2 ){
+        std::vector<int> big(big_size);
+        for( auto i = 0; i < big_size; ++i ){ big[i] = 2*i; }
+        Eytzinger_Index eytzinger(big.data(), 0, big_size-1);
+        Van_Emde_Boas_Index veb(big.data(), 0, big_size-1);
+
+        std::uniform_int_distribution<int> dist(0, 2*big_size-1);
+        std::vector<int> queries(QUERIES);
+        std::generate(queries.begin(), queries.end(), [&]{ return dist(rng); });
+
+        for( auto q : queries ){
+            if( veb.search(q) != binary_search(big.data(), q, 0, big_size-1) ){
+                std::cout << "Mismatch for key " << q << std::endl;
+                return 1;
+            }
+        }
+
+        auto binary_ns    = time_per_query(queries, [&](int q){ return binary_search(big.data(), q, 0, big_size-1); });
+        auto eytzinger_ns = time_per_query(queries, [&](int q){ return eytzinger.search(q); });
+        auto veb_ns       = time_per_query(queries, [&](int q){ return veb.search(q); });
+
+        std::cout << "  " << big_size << "  " << binary_ns << "  " << eytzinger_ns << "  " << veb_ns << std::endl;
+    }
+
+    return 0;
+}
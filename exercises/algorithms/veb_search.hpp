@@ -0,0 +1,145 @@
+#pragma once
+
+#include <bit>        //std::bit_width, std::countr_one
+#include <climits>    //INT_MAX
+#include <cstddef>    //std::size_t
+#include <vector>
+#include "aligned_allocator.hpp"
+#include "binary_search.hpp"
+
+// Search index that stores a sorted array in van Emde Boas order
+// Notes:
+// - The implicit search tree is cut in half by height: a top tree and a row of bottom trees hanging
+//   off its leaves. The top tree is laid out first, then each bottom tree after it, and every piece is
+//   laid out the same way recursively.
+// - At some level of that recursion the pieces fit in a cache line, at another in a page, at another
+//   in L2. A root to leaf walk crosses O(log_B n) pieces for every block size B at once, so there is no
+//   block size to tune per machine (the S-tree picks one, the Eytzinger layout prefetches for one).
+// - The tree is complete: n is padded up to 2^h - 1 nodes with INT_MAX. The padding sits after every
+//   real element in sorted order, so it never changes an answer. Worst case that doubles the memory.
+// - We never store child pointers. Walking down we remember the position of the node at every depth,
+//   and three small per depth tables (from "Cache Oblivious Search Trees via Binary Trees of Small
+//   Height", Brodal, Fagerberg, Jacob) turn a node's BFS number into its position in O(1).
+// - Ranks returned by search() are indices into the original sorted array, so this is a drop-in
+//   replacement for binary_search(a, val, begin, end).
+class Van_Emde_Boas_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        static constexpr int MAX_HEIGHT = 33;
+
+        std::vector<int, Aligned_Allocator<int>> tree;
+        size_type size;
+        int height;
+        int offset;
+
+        // For a node at depth d whose subtree is the root of a bottom tree in the split that made it:
+        //   top_size[d]    - nodes in the top tree of that split, 2^(top height) - 1
+        //   bottom_size[d] - nodes in each bottom tree, 2^(bottom height) - 1
+        //   top_depth[d]   - depth of the root of that split, whose position starts the whole block
+        size_type top_size[MAX_HEIGHT];
+        size_type bottom_size[MAX_HEIGHT];
+        int top_depth[MAX_HEIGHT];
+
+        void split( int top, int h ){
+            if( h <= 1 ){ return; }
+            int top_height = h / 2;
+            int d = top + top_height;
+            top_size[d] = (size_type(1) << top_height) - 1;
+            bottom_size[d] = (size_type(1) << (h - top_height)) - 1;
+            top_depth[d] = top;
+            split(top, top_height);
+            split(d, h - top_height);
+        }
+
+        // Position of the node with BFS number k (root is 1) at depth d > 0, given the positions of its ancestors
+        // Notes:
+        // - The bottom trees of a block come right after its top tree, left to right. k & top_size[d]
+        //   keeps the last (d - top_depth[d]) bits of k, which is the number of our bottom tree.
+        size_type position( const size_type path[], size_type k, int d ) const {
+            return path[top_depth[d]] + top_size[d] + (k & top_size[d]) * bottom_size[d];
+        }
+
+        // In order walk of the implicit tree so the sorted input lands in van Emde Boas order
+        size_type build( const int sorted[], size_type i, size_type k, int d, size_type path[] ){
+            if( d == height ){ return i; }
+            path[d] = d == 0 ? 0 : position(path, k, d);
+            i = build(sorted, i, 2*k, d + 1, path);
+            tree[path[d]] = i < size ? sorted[i] : INT_MAX;
+            ++i;
+            return build(sorted, i, 2*k + 1, d + 1, path);
+        }
+
+        // Walk down the tree and return the sorted rank of the lower bound (size if none) and its position
+        // Notes:
+        // - Same walk as the Eytzinger index: one compare per level, no early exit. k collects the path,
+        //   and the lower bound is the last node where we went left.
+        // - Both children's positions only need positions we already know, so we work them out before
+        //   the compare and prefetch both. The load of the next node then overlaps the current one,
+        //   the same trick search::lower_bound plays with its two possible midpoints.
+        // - The selects go through search::select (binary_search.hpp), a plain ?: here became a branch.
+        size_type descend( int val, size_type& found_at ) const {
+            size_type path[MAX_HEIGHT];
+            size_type k = 1;
+            size_type p = 0;
+            size_type found = 0;
+            for( int d = 0; d < height; ++d ){
+                path[d] = p;
+                // siblings sit in neighbouring bottom trees, so the right child is one bottom tree further
+                size_type left = 0, step = 0;
+                if( d + 1 < height ){
+                    left = position(path, 2*k, d + 1);
+                    step = bottom_size[d + 1];
+                    search::prefetch(tree.data() + left);
+                    search::prefetch(tree.data() + left + step);
+                }
+                bool right = tree[p] < val;
+                found = search::select(right, found, p);
+                k = 2*k + right;
+                p = left + search::select(right, step, size_type(0));
+            }
+            found_at = found;
+
+            // Strip the trailing right turns plus the left turn, that leaves the BFS number of the lower bound
+            int ones = std::countr_one(k);
+            if( ones >= height ){ return size; }
+            int depth = height - 1 - ones;
+            size_type node = k >> (ones + 1);
+            // in order rank of a node in a complete tree: its subtree's left half comes first
+            size_type in_order = ((node - (size_type(1) << depth)) * 2 + 1) << (height - 1 - depth);
+            size_type rank = in_order - 1;
+            return rank < size ? rank : size;
+        }
+
+    public:
+        // Build from the inclusive range [begin, end] of a sorted array, same convention as binary_search
+        Van_Emde_Boas_Index( const int sorted[], int begin, int end ):
+            size(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0),
+            height(std::bit_width(size)),
+            offset(begin)
+        {
+            split(0, height);
+            tree.resize((size_type(1) << height) - 1);
+            size_type path[MAX_HEIGHT];
+            build(sorted + begin, 0, 1, 0, path);
+        }
+
+        size_type getSize() const { return size; }
+        int getHeight() const { return height; }
+
+        // Index of the first element >= val in the original array, or end+1 if there is none
+        int lower_bound( int val ) const {
+            size_type found;
+            return offset + static_cast<int>(descend(val, found));
+        }
+
+        // Index of val in the original array or -1, matching binary_search
+        int search( int val ) const {
+            size_type found;
+            size_type rank = descend(val, found);
+            return (rank < size && tree[found] == val) ? offset + static_cast<int>(rank) : -1;
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+};
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <span>
+#include <vector>
+#include "bloom_filter.hpp"
+#include "../algorithms/binary_search.hpp"
+#include "../algorithms/sequential_search.hpp"
+#include "../algorithms/benchmark_timer.hpp"
+
+int main(){
+
+    std::mt19937 rng;
+    rng.seed(123456789);
+
+    // The keys are the even numbers, so every odd query is a guaranteed miss
+    const int SIZE = 1 << 20;
+    std::vector<int> evens(SIZE);
+    for( int i = 0; i < SIZE; ++i ){ evens[i] = 2 * i; }
+
+    // No false negatives, and the measured false positive rate should be close to what we asked for
+    std::cout << "Target      Measured    Bits/key" << std::endl;
+    for( double target : { 0.05, 0.01, 0.001 } ){
+        Blocked_Bloom_Filter filter(evens.data(), 0, SIZE-1, target);
+        for( auto v : evens ){
+            if( !filter.may_contain(v) ){
+                std::cout << "False negative for " << v << std::endl;
+                return 1;
+            }
+        }
+        int false_positives = 0;
+        for( int i = 0; i < SIZE; ++i ){ false_positives += filter.may_contain(2 * i + 1); }
+        std::cout << target << "        " << static_cast<double>(false_positives) / SIZE << "    "
+                  << 8.0 * static_cast<double>(filter.getBytes()) / SIZE << std::endl;
+    }
+
+    // Mostly-miss lookups, 90% of the queries are odd
+    const int QUERIES = 1 << 20;
+    std::uniform_int_distribution<int> any_index(0, SIZE-1);
+    std::vector<int> queries(QUERIES);
+    for( auto& q : queries ){ q = 2 * any_index(rng) + (rng() % 10 != 0); }
+
+    Blocked_Bloom_Filter filter(evens.data(), 0, SIZE-1, 0.01);
+
+    // time_per_query leaves the sum of the answers in sink, we print it so the runs can be compared
+    std::cout << std::endl << "binary_search on " << SIZE << " ints, 90% misses:" << std::endl;
+    double plain_ns = time_per_query(queries, [&](int q){ return binary_search(evens.data(), q, 0, SIZE-1); });
+    std::cout << "  plain:        " << sink << " checksum, " << plain_ns << " ns/lookup" << std::endl;
+    double bloom_ns = time_per_query(queries, [&](int q){ return filter.may_contain(q) ? binary_search(evens.data(), q, 0, SIZE-1) : -1; });
+    std::cout << "  bloom first:  " << sink << " checksum, " << bloom_ns << " ns/lookup" << std::endl;
+
+    // Filter the whole stream up front, then only search the survivors
+    {
+        std::vector<std::size_t> survivors(QUERIES);
+        long long sum = 0;
+        std::size_t kept = 0;
+        double elapsed = time_ns([&]{
+            kept = filter.may_contain_batch(queries.data(), QUERIES, survivors.data());
+            sum -= static_cast<long long>(QUERIES - kept);
+            for( std::size_t s = 0; s < kept; ++s ){ sum += binary_search(evens.data(), queries[survivors[s]], 0, SIZE-1); }
+        });
+        sink = sum;
+        std::cout << "  batch filter: " << sum << " checksum, " << elapsed / QUERIES << " ns/lookup, "
+                  << kept << " of " << QUERIES << " searched" << std::endl;
+    }
+
+    // sequential_search is O(n) per lookup, so use a smaller unsorted array and fewer queries
+    const int SCAN_SIZE = 1 << 14;
+    std::vector<int> unsorted(evens.begin(), evens.begin() + SCAN_SIZE);
+    std::shuffle(unsorted.begin(), unsorted.end(), rng);
+    Blocked_Bloom_Filter scan_filter(unsorted.data(), 0, SCAN_SIZE-1, 0.01);
+    for( auto& q : queries ){ q = 2 * (any_index(rng) % SCAN_SIZE) + (rng() % 10 != 0); }
+
+    std::cout << std::endl << "sequential_search on " << SCAN_SIZE << " ints, 90% misses:" << std::endl;
+    std::span<const int> scan_queries(queries.data(), 1 << 14);
+    double scan_ns = time_per_query(scan_queries, [&](int q){ return sequential_search(unsorted.data(), q, 0, SCAN_SIZE-1); });
+    std::cout << "  plain:        " << sink << " checksum, " << scan_ns << " ns/lookup" << std::endl;
+    double scan_bloom_ns = time_per_query(scan_queries, [&](int q){ return scan_filter.may_contain(q) ? sequential_search(unsorted.data(), q, 0, SCAN_SIZE-1) : -1; });
+    std::cout << "  bloom first:  " << sink << " checksum, " << scan_bloom_ns << " ns/lookup" << std::endl;
+
+    return 0;
+}
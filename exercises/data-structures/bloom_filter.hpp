@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cmath>      //std::exp, std::pow, std::sqrt
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint32_t, std::uint64_t
+#include <stdexcept>  //std::invalid_argument
+#include <string>     //std::to_string
+#include <vector>
+#include "../algorithms/aligned_allocator.hpp"
+#include "../algorithms/binary_search.hpp"
+#include "../algorithms/sequential_search.hpp"
+
+// Cache line blocked Bloom filter over int keys
+// Notes:
+// - A plain Bloom filter sets k bits anywhere in a big bit array, so a query costs k cache misses.
+//   Here a key hashes to one 256 bit block (32 bytes, half a cache line) and all 8 of its bits live
+//   in that block, one bit in each of the block's 8 words. A query is one cache miss.
+// - The bit in word i comes from multiplying the key's hash by an odd salt and keeping the top 5 bits.
+//   With AVX2 that's one vpmulld + vpsrld + vpsllvd for all 8 words, and vptest checks the 8 bits
+//   against the block at once. Other cpus run the same math one word at a time.
+// - may_contain() == false means the key is definitely absent. true means "go and look".
+// - The false positive rate picks the size. Packing keys into blocks costs a little accuracy versus
+//   a plain filter because some blocks get more than their share of keys, so we size from the exact
+//   rate of a blocked filter: average the per-block rate over the Poisson spread of keys per block.
+//   1% takes ~10.5 bits per key, 0.1% ~16.
+class Blocked_Bloom_Filter {
+
+    using size_type = std::size_t;
+
+    private:
+        static constexpr size_type WORDS = 8;
+        static constexpr std::uint32_t SALTS[WORDS] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+        };
+
+        std::vector<std::uint32_t, Aligned_Allocator<std::uint32_t>> words;
+        size_type blocks;
+        size_type keys;
+        bool use_avx2;
+
+        // splitmix64 finalizer: every input bit affects every output bit
+        static std::uint64_t mix( int val ){
+            std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(val)) + 0x9E3779B97F4A7C15ull;
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+            return h ^ (h >> 31);
+        }
+
+        // Top 32 bits pick the block (multiply-shift instead of a modulo), the low 32 bits the bits
+        size_type blockOf( std::uint64_t h ) const {
+            return static_cast<size_type>(((h >> 32) * static_cast<std::uint64_t>(blocks)) >> 32);
+        }
+
+        bool testScalar( const std::uint32_t* block, std::uint32_t h ) const {
+            for( size_type i = 0; i < WORDS; ++i ){
+                std::uint32_t bit = std::uint32_t(1) << ((h * SALTS[i]) >> 27);
+                if( (block[i] & bit) == 0 ){ return false; }
+            }
+            return true;
+        }
+
+#if defined(SEARCH_X86_SIMD)
+        SEARCH_TARGET("avx2")
+        static __m256i bitMask( std::uint32_t h ){
+            const __m256i salts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(SALTS));
+            __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(h)), salts), 27);
+            return _mm256_sllv_epi32(_mm256_set1_epi32(1), bit);
+        }
+
+        SEARCH_TARGET("avx2")
+        static bool testAvx2( const std::uint32_t* block, std::uint32_t h ){
+            // testc is 1 when every bit of the mask is also set in the block
+            return _mm256_testc_si256(_mm256_load_si256(reinterpret_cast<const __m256i*>(block)), bitMask(h));
+        }
+#endif
+
+        bool test( int val ) const {
+            std::uint64_t h = mix(val);
+            const std::uint32_t* block = words.data() + blockOf(h) * WORDS;
+#if defined(SEARCH_X86_SIMD)
+            if( use_avx2 ){ return testAvx2(block, static_cast<std::uint32_t>(h)); }
+#endif
+            return testScalar(block, static_cast<std::uint32_t>(h));
+        }
+
+    public:
+        // Expected false positive rate of a blocked filter holding `n` keys in `block_count` blocks
+        static double estimate_false_positive_rate( size_type n, size_type block_count ){
+            if( n == 0 ){ return 0.0; }
+            double per_block = static_cast<double>(n) / static_cast<double>(block_count);
+            double probability = std::exp(-per_block);    // Poisson(per_block) at 0 keys
+            double rate = 0.0;
+            size_type last = static_cast<size_type>(per_block + 10 * std::sqrt(per_block) + 20);
+            for( size_type i = 1; i <= last; ++i ){
+                probability *= per_block / static_cast<double>(i);
+                // a word with i keys in its block has each bit set with 1 - (31/32)^i
+                rate += probability * std::pow(1.0 - std::pow(31.0 / 32.0, static_cast<double>(i)), static_cast<double>(WORDS));
+            }
+            return rate;
+        }
+
+        // Empty filter sized for `expected_keys` at the given false positive rate
+        // Notes:
+        // - Throws std::invalid_argument if the rate isn't in (0, 1).
+        explicit Blocked_Bloom_Filter( size_type expected_keys, double false_positive_rate = 0.01 ):
+            blocks(1),
+            keys(0),
+            use_avx2(search::simd_level() >= search::Simd_Level::avx2)
+        {
+            if( !(false_positive_rate > 0.0 && false_positive_rate < 1.0) ){
+                throw std::invalid_argument("False positive rate must be between 0 and 1. Got " + std::to_string(false_positive_rate));
+            }
+
+            // The rate only goes down as blocks go up, so binary search for the fewest blocks that make it
+            size_type lo = 1, hi = expected_keys + 1;
+            while( estimate_false_positive_rate(expected_keys, hi) > false_positive_rate ){ hi *= 2; }
+            while( lo < hi ){
+                size_type mid = lo + (hi - lo) / 2;
+                if( estimate_false_positive_rate(expected_keys, mid) <= false_positive_rate ){ hi = mid; }
+                else { lo = mid + 1; }
+            }
+            blocks = lo;
+            words.assign(blocks * WORDS, 0);
+        }
+
+        // Filter holding every value of the inclusive range [begin, end]
+        Blocked_Bloom_Filter( const int search_array[], int begin, int end, double false_positive_rate = 0.01 ):
+            Blocked_Bloom_Filter(end >= begin ? static_cast<size_type>(end - begin) + 1 : 0, false_positive_rate)
+        {
+            for( int i = begin; i <= end; ++i ){ insert(search_array[i]); }
+        }
+
+        size_type getBlockCount() const { return blocks; }
+        size_type getBytes() const { return words.size() * sizeof(std::uint32_t); }
+        double getFalsePositiveRate() const { return estimate_false_positive_rate(keys, blocks); }
+
+        void insert( int val ){
+            std::uint64_t h = mix(val);
+            std::uint32_t* block = words.data() + blockOf(h) * WORDS;
+            for( size_type i = 0; i < WORDS; ++i ){
+                block[i] |= std::uint32_t(1) << ((static_cast<std::uint32_t>(h) * SALTS[i]) >> 27);
+            }
+            ++keys;
+        }
+
+        // false: val was never inserted. true: it probably was.
+        bool may_contain( int val ) const { return test(val); }
+
+        // Filter a stream of queries before the real search
+        // Notes:
+        // - Writes the positions q of the queries that may be present into survivors and returns how
+        //   many there are. Only those need the real search, everything else is a miss.
+        // - The block loads are the cache misses, so we hash and prefetch Ahead queries in front.
+        template<size_type Ahead = 8>
+        size_type may_contain_batch( const int queries[], size_type n, size_type survivors[] ) const {
+            size_type count = 0;
+            for( size_type q = 0; q < n; ++q ){
+                if( q + Ahead < n ){ search::prefetch(words.data() + blockOf(mix(queries[q + Ahead])) * WORDS); }
+                survivors[count] = q;
+                count += test(queries[q]) ? 1 : 0;
+            }
+            return count;
+        }
+};
@@ -0,0 +1,124 @@
+#include <iostream>
+#include <algorithm>
+#include <climits>    //INT_MIN, INT_MAX
+#include <random>     //std::mt19937
+#include <vector>
+#include "fractional_cascading.hpp"
+#include "../algorithms/binary_search.hpp"
+#include "../algorithms/benchmark_timer.hpp"
+
+// Every position must match std::lower_bound on the matching array
+bool check( const Fractional_Cascading& fc, const std::vector<int>& keys ){
+    std::vector<int> positions(fc.getArrayCount());
+    for( auto key : keys ){
+        fc.lower_bounds(key, positions.data());
+        for( std::size_t i = 0; i < fc.getArrayCount(); ++i ){
+            const std::vector<int>& a = fc.getArray(i);
+            if( positions[i] != std::lower_bound(a.begin(), a.end(), key) - a.begin() ){
+                std::cout << "Mismatch for " << key << " in array " << i << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(){
+
+    Fractional_Cascading small({ { 3, 8, 15, 22 }, { 1, 8, 9, 30, 41 }, {}, { 8, 8, 8 }, { 2, 5, 13, 21, 34 } });
+    int results[5];
+    small.search(8, results);
+    std::cout << "search(8):";
+    for( auto r : results ){ std::cout << " " << r; }
+    std::cout << std::endl;
+    small.lower_bounds(14, results);
+    std::cout << "lower_bounds(14):";
+    for( auto r : results ){ std::cout << " " << r; }
+    std::cout << std::endl;
+
+    // Random arrays of mixed sizes with lots of duplicates, then replace a few of them
+    std::mt19937 rng;
+    rng.seed(123456789);
+    auto random_arrays = [&](std::size_t k, int max_size, int max_value){
+        std::uniform_int_distribution<int> size(0, max_size);
+        std::uniform_int_distribution<int> value(-max_value, max_value);
+        std::vector<std::vector<int>> arrays(k);
+        for( auto& a : arrays ){
+            a.resize(size(rng));
+            for( auto& e : a ){ e = value(rng); }
+            std::sort(a.begin(), a.end());
+        }
+        return arrays;
+    };
+
+    std::vector<int> keys = { INT_MIN, INT_MAX, -1001, 1001 };
+    for( int v = -1000; v <= 1000; ++v ){ keys.push_back(v); }
+
+    Fractional_Cascading checked(random_arrays(40, 300, 1000));
+    if( !check(checked, keys) ){ return 1; }
+    for( std::size_t i : { std::size_t(39), std::size_t(0), std::size_t(17), std::size_t(17) } ){
+        auto replacement = random_arrays(1, 600, 1000)[0];
+        checked.replace(i, replacement);
+        if( !check(checked, keys) ){ return 1; }
+    }
+    checked.replace(5, std::vector<int>{ INT_MIN, INT_MIN, 0, INT_MAX });
+    if( !check(checked, keys) ){ return 1; }
+
+    try {
+        checked.replace(3, std::vector<int>{ 5, 4 });
+    } catch( const std::invalid_argument& e ){
+        std::cout << "replace with unsorted input: " << e.what() << std::endl;
+    }
+
+    // Time one key across 64 arrays of up to 64K ints each
+    const std::size_t K = 64;
+    const int QUERIES = 1 << 16;
+    Fractional_Cascading big(random_arrays(K, 1 << 16, 1 << 30));
+    std::size_t elements = 0;
+    for( std::size_t i = 0; i < K; ++i ){ elements += big.getArray(i).size(); }
+
+    std::vector<int> queries(QUERIES);
+    std::uniform_int_distribution<int> any_key(-(1 << 30), 1 << 30);
+    for( auto& q : queries ){ q = any_key(rng); }
+    if( !check(big, std::vector<int>(queries.begin(), queries.begin() + 1000)) ){ return 1; }
+
+    std::vector<int> positions(K);
+    double separate_ns = time_per_query(queries, [&](int q){
+        long long sum = 0;
+        for( std::size_t i = 0; i < K; ++i ){
+            const std::vector<int>& a = big.getArray(i);
+            sum += static_cast<long long>(search::lower_bound(a.data(), a.size(), q));
+        }
+        return sum;
+    });
+
+    double cascade_ns = time_per_query(queries, [&](int q){
+        big.lower_bounds(q, positions.data());
+        long long sum = 0;
+        for( auto p : positions ){ sum += p; }
+        return sum;
+    });
+
+    std::vector<int> batch_positions(QUERIES * K);
+    double batch_ns = time_ns([&]{ big.lower_bounds_batch(queries.data(), queries.size(), batch_positions.data()); });
+
+    // The batch must hand back exactly what the single key lookups do
+    for( int q = 0; q < QUERIES; ++q ){
+        big.lower_bounds(queries[q], positions.data());
+        if( !std::equal(positions.begin(), positions.end(), batch_positions.begin() + q * K) ){
+            std::cout << "Batch mismatch for " << queries[q] << std::endl;
+            return 1;
+        }
+    }
+
+    double rebuild_ns = time_ns([&]{ big.replace(K / 2, big.getArray(K / 2)); });
+
+    std::cout << std::endl << "One key across " << K << " arrays, " << elements << " ints, "
+              << big.getEntryCount() << " cascade entries:" << std::endl;
+    std::cout << "  " << K << " x lower_bound:     " << separate_ns << " ns/key" << std::endl;
+    std::cout << "  lower_bounds:         " << cascade_ns << " ns/key" << std::endl;
+    std::cout << "  lower_bounds_batch:   " << batch_ns / QUERIES << " ns/key" << std::endl;
+    std::cout << "  replace(" << K / 2 << "):          " << rebuild_ns / 1e6 << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <optional>
+#include <random>     //std::mt19937
+#include <span>
+#include <vector>
+#include "hash_index.hpp"
+#include "../algorithms/sequential_search.hpp"
+#include "../algorithms/benchmark_timer.hpp"
+
+int main(){
+
+    int a[] = { 17, 4, 99, -3, 4, 42, 17, 0, 99, 8 };
+    const int SIZE = static_cast<int>(sizeof(a) / sizeof(a[0]));
+    Hash_Index index(a, 0, SIZE-1);
+
+    std::cout << "Distinct values: " << index.getSize() << " in " << index.getCapacity() << " slots" << std::endl;
+    for( int val : { 17, 4, 99, -3, 7 } ){
+        std::cout << "search(" << val << "): " << index.search(val) << "  sequential_search: " << sequential_search(a, val, 0, SIZE-1) << std::endl;
+    }
+
+    // Must agree with sequential_search, duplicates included, for any sub range
+    std::mt19937 rng;
+    rng.seed(123456789);
+    std::uniform_int_distribution<int> small_values(-50, 50);
+    std::vector<int> data(400);
+    for( auto& e : data ){ e = small_values(rng); }
+    for( int begin = 0; begin < 40; begin += 3 ){
+        for( int end = begin - 1; end < static_cast<int>(data.size()); end += 29 ){
+            Hash_Index checked(data.data(), begin, end);
+            for( int val = -55; val <= 55; ++val ){
+                if( checked.search(val) != sequential_search(data.data(), val, begin, end) ){
+                    std::cout << "Mismatch for " << val << " in [" << begin << ", " << end << "]" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    // Time lookups on a table far bigger than cache
+    // Notes:
+    // - Half the queries hit and half miss.
+    const int BIG_SIZE = 1 << 22;
+    const int QUERIES = 1 << 20;
+    std::uniform_int_distribution<int> any_int;
+    std::vector<int> big(BIG_SIZE);
+    for( auto& e : big ){ e = any_int(rng); }
+    std::vector<int> queries(QUERIES);
+    std::uniform_int_distribution<int> any_index(0, BIG_SIZE-1);
+    for( int q = 0; q < QUERIES; ++q ){ queries[q] = q % 2 ? big[any_index(rng)] : any_int(rng); }
+
+    std::optional<Hash_Index> built;
+    double build_ns = time_ns([&]{ built.emplace(big.data(), 0, BIG_SIZE-1); });
+    const Hash_Index& big_index = *built;
+
+    double lookup_ns = time_per_query(queries, [&](int q){ return big_index.search(q); });
+
+    std::vector<int> results(QUERIES);
+    double batch_ns = time_ns([&]{ big_index.search_batch(queries.data(), queries.size(), results.data()); });
+    long long sum = 0;
+    for( auto r : results ){ sum += r; }
+    sink = sum;
+
+    // sequential_search is O(n), so only time a few of those
+    const int SCANS = 64;
+    double scan_ns = time_per_query(std::span<const int>(queries.data(), SCANS), [&](int q){ return sequential_search(big.data(), q, 0, BIG_SIZE-1); });
+
+    std::cout << std::endl << BIG_SIZE << " ints, built in " << build_ns / 1e6 << " ms, "
+              << big_index.getCapacity() * 8 / (1 << 20) << " MB of slots" << std::endl;
+    std::cout << "  sequential_search:  " << scan_ns << " ns/lookup" << std::endl;
+    std::cout << "  Hash_Index::search: " << lookup_ns << " ns/lookup" << std::endl;
+    std::cout << "  search_batch:       " << batch_ns / QUERIES << " ns/lookup" << std::endl;
+
+    return 0;
+}
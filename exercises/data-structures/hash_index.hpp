@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bit>        //std::bit_ceil, std::countr_zero
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint32_t, std::uint64_t
+#include <vector>
+#include "../algorithms/aligned_allocator.hpp"
+#include "../algorithms/binary_search.hpp"
+
+// Flat open addressing hash index over an unsorted int array
+// Notes:
+// - Maps each distinct value to the index of its first occurrence, so search() answers exactly what
+//   sequential_search(a, val, begin, end) would, in O(1) expected time instead of O(n).
+// - Built in one pass. Walking the array front to back and skipping values already in the table
+//   keeps the first occurrence for free.
+// - Each slot holds the key and its index side by side (8 bytes), so the compare and the answer come
+//   from the same cache line. Linear probing keeps walking that line, and at a load factor of at most
+//   1/2 the expected probe run is short, so a lookup is about one cache miss.
+// - Fibonacci hashing: multiply by 2^64 / golden ratio and keep the top bits. It spreads sequential
+//   and strided keys well and the capacity can stay a power of two.
+// - The table is sized from the range length, so it never rehashes. With lots of duplicates it is
+//   bigger than it needs to be, which only makes probe runs shorter.
+class Hash_Index {
+
+    using size_type = std::size_t;
+
+    private:
+        struct Slot {
+            int key;
+            int index;   // -1 marks an empty slot
+        };
+
+        std::vector<Slot, Aligned_Allocator<Slot>> slots;
+        size_type mask;
+        int shift;
+        size_type count;
+
+        size_type home( int val ) const {
+            std::uint64_t h = static_cast<std::uint64_t>(static_cast<std::uint32_t>(val)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_type>(h >> shift);
+        }
+
+    public:
+        // Build from the inclusive range [begin, end], same convention as sequential_search
+        Hash_Index( const int search_array[], int begin, int end ):
+            count(0)
+        {
+            size_type n = end >= begin ? static_cast<size_type>(end - begin) + 1 : 0;
+            size_type capacity = std::bit_ceil(2 * n < 8 ? size_type(8) : 2 * n);
+            slots.assign(capacity, Slot{ 0, -1 });
+            mask = capacity - 1;
+            shift = 64 - std::countr_zero(capacity);
+
+            for( int i = begin; i <= end && n > 0; ++i ){
+                int val = search_array[i];
+                size_type s = home(val);
+                while( slots[s].index != -1 && slots[s].key != val ){ s = (s + 1) & mask; }
+                if( slots[s].index == -1 ){
+                    slots[s] = Slot{ val, i };
+                    ++count;
+                }
+            }
+        }
+
+        // Number of distinct values
+        size_type getSize() const { return count; }
+        size_type getCapacity() const { return slots.size(); }
+
+        // Index of the first occurrence of val, or -1
+        int search( int val ) const {
+            size_type s = home(val);
+            while( true ){
+                const Slot& slot = slots[s];
+                if( slot.index == -1 || slot.key == val ){ return slot.index; }
+                s = (s + 1) & mask;
+            }
+        }
+
+        bool contains( int val ) const { return search(val) != -1; }
+
+        // Look up a batch of keys, results[i] = search(queries[i])
+        // Notes:
+        // - Hashing is cheap, the slot load is the cache miss. We hash and prefetch Ahead keys in front
+        //   of the one we are resolving so several misses are in flight at once.
+        template<size_type Ahead = 8>
+        void search_batch( const int queries[], size_type n, int results[] ) const {
+            for( size_type q = 0; q < n; ++q ){
+                if( q + Ahead < n ){ search::prefetch(&slots[home(queries[q + Ahead])]); }
+                results[q] = search(queries[q]);
+            }
+        }
+};
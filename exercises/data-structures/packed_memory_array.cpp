@@ -0,0 +1,99 @@
+#include <iostream>
+#include <algorithm>
+#include <random>     //std::mt19937
+#include <set>
+#include <vector>
+#include "packed_memory_array.hpp"
+#include "../algorithms/benchmark_timer.hpp"
+
+int main(){
+
+    Packed_Memory_Array<int> pma;
+    for( int v : { 42, 7, 19, 7, 3, 88, 61, 25 } ){ pma.insert(v); }
+    pma.remove(19);
+
+    std::cout << "Size: " << pma.getSize() << " Capacity: " << pma.getCapacity() << std::endl;
+    for( auto v : pma.values() ){ std::cout << v << ", "; }
+    std::cout << std::endl;
+    std::cout << "contains(61): " << std::boolalpha << pma.contains(61) << " contains(19): " << pma.contains(19) << std::endl;
+    std::cout << "scan [5, 45]: ";
+    pma.scan(5, 45, [](int v){ std::cout << v << " "; });
+    std::cout << std::endl;
+
+    // Random inserts and deletes checked against std::multiset
+    std::mt19937 rng;
+    rng.seed(123456789);
+    {
+        Packed_Memory_Array<int> checked;
+        std::multiset<int> reference;
+        std::uniform_int_distribution<int> key(0, 5000);
+        for( int op = 0; op < 200000; ++op ){
+            int v = key(rng);
+            // mostly inserts for the first half, mostly deletes for the second so we grow and shrink
+            bool insert = (op < 100000) ? (rng() % 10 < 7) : (rng() % 10 < 3);
+            if( insert ){
+                checked.insert(v);
+                reference.insert(v);
+            } else {
+                auto it = reference.find(v);
+                bool expected = it != reference.end();
+                if( expected ){ reference.erase(it); }
+                if( checked.remove(v) != expected ){
+                    std::cout << "Remove mismatch for " << v << std::endl;
+                    return 1;
+                }
+            }
+            if( checked.contains(v) != (reference.count(v) > 0) || checked.getSize() != reference.size() ){
+                std::cout << "Mismatch after op " << op << std::endl;
+                return 1;
+            }
+        }
+        auto all = checked.values();
+        if( !std::equal(all.begin(), all.end(), reference.begin(), reference.end()) ){
+            std::cout << "Contents differ from std::multiset" << std::endl;
+            return 1;
+        }
+    }
+
+    // Time a stream of random inserts
+    // Notes:
+    // - The sorted vector pays a memmove of half the array per insert on average.
+    const int INSERTS = 1 << 18;
+    std::vector<int> keys(INSERTS);
+    std::uniform_int_distribution<int> any_key(0, 1 << 30);
+    for( auto& k : keys ){ k = any_key(rng); }
+
+    std::vector<int> sorted;
+    double vector_ns = time_ns([&]{
+        for( auto k : keys ){ sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), k), k); }
+    });
+
+    Packed_Memory_Array<int> big;
+    double pma_ns = time_ns([&]{
+        for( auto k : keys ){ big.insert(k); }
+    });
+
+    std::cout << std::endl << INSERTS << " random inserts:" << std::endl;
+    std::cout << "  sorted std::vector:  " << vector_ns / INSERTS << " ns/insert" << std::endl;
+    std::cout << "  Packed_Memory_Array: " << pma_ns / INSERTS << " ns/insert, "
+              << big.getCapacity() << " slots, segments of " << big.getSegmentSize() << std::endl;
+
+    // Lookups and a full range scan on both
+    double vector_lookup = time_per_query(keys, [&](int k){ return binary_search(sorted.data(), k, 0, static_cast<int>(sorted.size())-1) >= 0; });
+    double pma_lookup = time_per_query(keys, [&](int k){ return big.contains(k); });
+
+    std::cout << "  lookups: vector " << vector_lookup << " ns, PMA " << pma_lookup << " ns" << std::endl;
+
+    long long sum = 0;
+    double vector_scan = time_ns([&]{
+        for( auto k : sorted ){ sum += k; }
+    });
+    double pma_scan = time_ns([&]{
+        big.scan(0, 1 << 30, [&sum](int k){ sum += k; });
+    });
+    sink = sum;
+
+    std::cout << "  full scan: vector " << vector_scan / INSERTS << " ns/element, PMA " << pma_scan / INSERTS << " ns/element" << std::endl;
+
+    return 0;
+}
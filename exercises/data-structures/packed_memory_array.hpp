@@ -0,0 +1,310 @@
+#pragma once
+
+#include <bit>        //std::bit_ceil, std::bit_width, std::countr_zero
+#include <cstddef>    //std::size_t
+#include <cstdint>    //std::uint64_t
+#include <functional> //std::less
+#include <vector>
+#include "../algorithms/binary_search.hpp"
+
+// Packed Memory Array
+// Notes:
+// - A sorted array with gaps spread through it. An insert usually finds a gap close by and only
+//   shifts a handful of elements instead of memmoving half the array.
+// - The array is cut into segments of ~log2(capacity) slots. The segments are the leaves of an
+//   implicit binary tree, each tree node covers a window of 2^level segments.
+// - Every level has a density range. An insert that overfills its segment walks up the tree until it
+//   finds a window that can take one more element while staying under that level's upper density,
+//   then spreads the window's elements evenly over it. Deletes do the same with the lower density.
+//   If even the root is out of range we double or halve the capacity.
+// - The upper density loosens from 0.75 at the root to 1.0 at the leaves, the lower one from 0.25 at
+//   the root down to 0.125. Windows higher up get rebalanced to a tighter density, which is what
+//   makes inserts and deletes O(log^2 n) amortized.
+// - Gap slots hold a copy of the closest element in front of them (the first element for gaps at the
+//   very front). So the slot array is sorted, gaps and all, and search::lower_bound runs over it
+//   unchanged. A lower bound can only land on an element or on a leading gap. A bitmap says which
+//   slots are real.
+// - Range scans walk the slots in order and skip gaps 64 at a time with the bitmap, so they read
+//   memory front to back like a plain array.
+template<class T, class Compare = std::less<>>
+class Packed_Memory_Array {
+
+    using value_type = T;
+    using size_type = std::size_t;
+
+    private:
+        static constexpr size_type MIN_CAPACITY = 16;
+        static constexpr double ROOT_UPPER = 0.75;
+        static constexpr double LEAF_UPPER = 1.0;
+        static constexpr double ROOT_LOWER = 0.25;
+        static constexpr double LEAF_LOWER = 0.125;
+
+        std::vector<value_type> slots;
+        std::vector<std::uint64_t> occupied;
+        std::vector<size_type> segment_counts;
+        size_type count;
+        size_type segment_size;
+        size_type height;       // levels above the leaves
+        Compare comp;
+
+        bool isOccupied( size_type i ) const { return (occupied[i / 64] >> (i % 64)) & 1; }
+        void setOccupied( size_type i ){ occupied[i / 64] |= std::uint64_t(1) << (i % 64); }
+        void clearOccupied( size_type i ){ occupied[i / 64] &= ~(std::uint64_t(1) << (i % 64)); }
+
+        // First real slot at or after i, or the capacity if there is none
+        size_type nextOccupied( size_type i ) const {
+            const size_type cap = slots.size();
+            if( i >= cap ){ return cap; }
+            size_type word = i / 64;
+            std::uint64_t bits = occupied[word] & (~std::uint64_t(0) << (i % 64));
+            while( bits == 0 ){
+                if( ++word == occupied.size() ){ return cap; }
+                bits = occupied[word];
+            }
+            size_type next = word * 64 + static_cast<size_type>(std::countr_zero(bits));
+            return next < cap ? next : cap;
+        }
+
+        // Density bounds for a window `level` steps above the leaves
+        double upperDensity( size_type level ) const {
+            if( height == 0 ){ return ROOT_UPPER; }
+            return LEAF_UPPER - (LEAF_UPPER - ROOT_UPPER) * static_cast<double>(level) / static_cast<double>(height);
+        }
+        double lowerDensity( size_type level ) const {
+            if( height == 0 ){ return ROOT_LOWER; }
+            return LEAF_LOWER + (ROOT_LOWER - LEAF_LOWER) * static_cast<double>(level) / static_cast<double>(height);
+        }
+
+        size_type windowCount( size_type first_segment, size_type segments ) const {
+            size_type total = 0;
+            for( size_type s = first_segment; s < first_segment + segments; ++s ){ total += segment_counts[s]; }
+            return total;
+        }
+
+        // Size the arrays for `capacity` slots, all of them empty
+        void allocate( size_type capacity ){
+            segment_size = std::bit_ceil(static_cast<size_type>(std::bit_width(capacity)));
+            if( segment_size < 8 ){ segment_size = 8; }
+            if( segment_size > capacity ){ segment_size = capacity; }
+            height = static_cast<size_type>(std::bit_width(capacity / segment_size)) - 1;
+
+            slots.assign(capacity, value_type{});
+            occupied.assign((capacity + 63) / 64, 0);
+            segment_counts.assign(capacity / segment_size, 0);
+        }
+
+        // Rewrite the gap slots from `from` up to the first element at or after `to`
+        // Notes:
+        // - Gaps copy the element in front of them, so slots[from-1] already holds the value to carry
+        //   unless everything in front of `from` is empty.
+        void refill( size_type from, size_type to ){
+            const size_type cap = slots.size();
+            const size_type first = nextOccupied(0);
+            if( first == cap ){ return; }
+
+            size_type stop = nextOccupied(to);
+            bool carrying = first < from;
+            value_type carry = carrying ? slots[from - 1] : value_type{};
+            for( size_type i = from; i < stop; ++i ){
+                if( isOccupied(i) ){
+                    carry = slots[i];
+                    carrying = true;
+                } else if( carrying ){
+                    slots[i] = carry;
+                }
+            }
+
+            // Gaps at the very front copy the first element
+            if( from <= first ){
+                for( size_type i = 0; i < first; ++i ){ slots[i] = slots[first]; }
+            }
+        }
+
+        // Spread `values` evenly over the slots of segments [first_segment, first_segment + segments)
+        void spread( const std::vector<value_type>& values, size_type first_segment, size_type segments ){
+            const size_type begin = first_segment * segment_size;
+            const size_type width = segments * segment_size;
+
+            for( size_type i = begin; i < begin + width; ++i ){ clearOccupied(i); }
+            for( size_type s = first_segment; s < first_segment + segments; ++s ){ segment_counts[s] = 0; }
+
+            const size_type n = values.size();
+            for( size_type j = 0; j < n; ++j ){
+                size_type i = begin + j * width / n;
+                slots[i] = values[j];
+                setOccupied(i);
+                ++segment_counts[i / segment_size];
+            }
+
+            refill(begin, begin + width);
+        }
+
+        // Elements of a window in order
+        // Notes:
+        // - If value isn't null it is slipped in before the first element at slot >= at.
+        // - The element at slot `skip` is left out, that's how deletes drop it.
+        std::vector<value_type> gather( size_type first_segment, size_type segments, const value_type* value, size_type at, size_type skip ) const {
+            const size_type begin = first_segment * segment_size;
+            const size_type end = begin + segments * segment_size;
+            std::vector<value_type> values;
+            values.reserve(windowCount(first_segment, segments) + 1);
+
+            bool pending = value != nullptr;
+            for( size_type i = nextOccupied(begin); i < end; i = nextOccupied(i + 1) ){
+                if( pending && i >= at ){
+                    values.push_back(*value);
+                    pending = false;
+                }
+                if( i != skip ){ values.push_back(slots[i]); }
+            }
+            if( pending ){ values.push_back(*value); }
+            return values;
+        }
+
+        // Put value in front of slot `at` inside a segment that still has a gap
+        // Notes:
+        // - Shift the elements between `at` and the closest gap by one slot. Prefer the gap after `at`
+        //   so equal elements keep their insertion order, otherwise use the one before it.
+        void insertIntoSegment( size_type leaf, size_type at, const value_type& value ){
+            const size_type begin = leaf * segment_size;
+            const size_type end = begin + segment_size;
+
+            size_type gap = at;
+            while( gap < end && isOccupied(gap) ){ ++gap; }
+
+            size_type pos;
+            if( gap < end ){
+                for( size_type i = gap; i > at; --i ){ slots[i] = slots[i - 1]; }
+                pos = at;
+            } else {
+                gap = at - 1;
+                while( isOccupied(gap) ){ --gap; }
+                for( size_type i = gap; i + 1 < at; ++i ){ slots[i] = slots[i + 1]; }
+                pos = at - 1;
+            }
+
+            slots[pos] = value;
+            setOccupied(gap);
+            ++segment_counts[leaf];
+            refill(pos, pos + 1);
+        }
+
+        // Double or halve the array and spread every element over it. Sets count from what is left.
+        void resize( size_type capacity, const value_type* value, size_type at, size_type skip ){
+            std::vector<value_type> values = gather(0, segment_counts.size(), value, at, skip);
+            allocate(capacity);
+            count = values.size();
+            if( count > 0 ){ spread(values, 0, segment_counts.size()); }
+        }
+
+    public:
+        explicit Packed_Memory_Array( Compare comp = Compare{} ):
+            count(0),
+            segment_size(0),
+            height(0),
+            comp(comp)
+        {
+            allocate(MIN_CAPACITY);
+        }
+
+        size_type getSize() const { return count; }
+        size_type getCapacity() const { return slots.size(); }
+        size_type getSegmentSize() const { return segment_size; }
+
+        // Slot of the first element not less than value, or the capacity
+        // Notes:
+        // - Slots move on every insert and delete, so only hold on to one until the next change.
+        size_type lower_bound( const value_type& value ) const {
+            return nextOccupied(search::lower_bound(slots.data(), slots.size(), value, comp));
+        }
+
+        bool contains( const value_type& value ) const {
+            size_type i = lower_bound(value);
+            return i < slots.size() && !comp(value, slots[i]);
+        }
+
+        // Insert value after any equal elements already in the array
+        void insert( const value_type& value ){
+            const size_type cap = slots.size();
+
+            // First slot holding something greater than value. Gaps copy the element in front of them,
+            // so this is always a real slot, a leading gap or the end.
+            size_type at = search::upper_bound(slots.data(), cap, value, comp);
+            size_type leaf = at == 0 ? 0 : (at - 1) / segment_size;
+
+            // Climb until a window can take one more element
+            for( size_type level = 0; level <= height; ++level ){
+                size_type segments = size_type(1) << level;
+                size_type first_segment = leaf / segments * segments;
+                size_type window_count = windowCount(first_segment, segments);
+                if( static_cast<double>(window_count + 1) <= upperDensity(level) * static_cast<double>(segments * segment_size) ){
+                    if( level == 0 ){
+                        // room in the segment, shift a few elements over instead of respreading it
+                        insertIntoSegment(leaf, at, value);
+                    } else {
+                        spread(gather(first_segment, segments, &value, at, SIZE_MAX), first_segment, segments);
+                    }
+                    ++count;
+                    return;
+                }
+            }
+
+            resize(cap * 2, &value, at, SIZE_MAX);
+        }
+
+        // Remove one copy of value. Returns false if it wasn't there.
+        bool remove( const value_type& value ){
+            const size_type cap = slots.size();
+            size_type at = lower_bound(value);
+            if( at == cap || comp(value, slots[at]) ){ return false; }
+
+            size_type leaf = at / segment_size;
+            for( size_type level = 0; level <= height; ++level ){
+                size_type segments = size_type(1) << level;
+                size_type first_segment = leaf / segments * segments;
+                size_type window_count = windowCount(first_segment, segments);
+                if( static_cast<double>(window_count - 1) >= lowerDensity(level) * static_cast<double>(segments * segment_size) ){
+                    if( level == 0 ){
+                        // still dense enough, just open a gap
+                        clearOccupied(at);
+                        --segment_counts[leaf];
+                        refill(at, at + 1);
+                    } else {
+                        spread(gather(first_segment, segments, nullptr, 0, at), first_segment, segments);
+                    }
+                    --count;
+                    return true;
+                }
+            }
+
+            // The whole array is too sparse. Halve it unless it is already as small as it gets.
+            if( cap > MIN_CAPACITY ){
+                resize(cap / 2, nullptr, 0, at);
+            } else {
+                spread(gather(0, segment_counts.size(), nullptr, 0, at), 0, segment_counts.size());
+                --count;
+            }
+            return true;
+        }
+
+        // Call fn(value) for every element in [lo, hi], in order
+        template<class Fn>
+        void scan( const value_type& lo, const value_type& hi, Fn fn ) const {
+            size_type first = lower_bound(lo);
+            for( size_type word = first / 64; word < occupied.size(); ++word ){
+                std::uint64_t bits = occupied[word];
+                if( word == first / 64 ){ bits &= ~std::uint64_t(0) << (first % 64); }
+                while( bits != 0 ){
+                    size_type i = word * 64 + static_cast<size_type>(std::countr_zero(bits));
+                    if( comp(hi, slots[i]) ){ return; }
+                    fn(slots[i]);
+                    bits &= bits - 1;
+                }
+            }
+        }
+
+        // Every element in order
+        std::vector<value_type> values() const {
+            return gather(0, segment_counts.size(), nullptr, 0, SIZE_MAX);
+        }
+};